@@ -0,0 +1,131 @@
+#ifndef SFML_PROJECT_BATCHRENDERER_H
+#define SFML_PROJECT_BATCHRENDERER_H
+
+#include "IterationFile.h"
+#include "Mandelbrot.h"
+#include "PngWriter.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Renders one view given on the command line straight to an image file, for machines without a display.
+// No window, OpenGL context or font is created: the frame goes from the Mandelbrot engine's framebuffer to
+// the encoder. The render uses every core and reports its wall time and iteration throughput.
+// PNG output is rendered in horizontal bands that are encoded while the next band is computed, so the
+// image size is bounded by the disk rather than by memory. Other formats are rendered as one frame.
+// While a PNG renders, a checkpoint next to it records the options and how far the file got, so a killed
+// render can be resumed from its last checkpoint instead of starting over.
+// The escape counts can be kept in an iteration file next to the image, which a later run recolors
+// without rendering again.
+class BatchRenderer {
+public:
+    struct Options {
+        // view center as decimal text, parsed at full precision
+        std::string centerRe {"-0.75"};
+        std::string centerIm {"0"};
+
+        // width of the view on the complex plane, the height follows from the aspect ratio
+        long double span {3.5L};
+
+        int maxIterations {1024};
+        sf::Vector2i size {1920, 1080};
+        std::string output {"mandelbrot.png"};
+        bool smoothColoring {};
+        double paletteOffset {};
+
+        // iteration file to store the render in, and one to color instead of rendering, empty for none
+        std::string data {};
+        std::string recolor {};
+
+        // rows per band of a PNG, 0 picks enough rows for about BandPixels pixels
+        int bandRows {};
+
+        // seconds between checkpoints of a PNG render, and whether to continue from the last one
+        double checkpointSeconds {60.0};
+        bool resume {};
+    };
+
+    // what a checkpoint records: the view, how far the file got and the totals of the bands in it
+    struct Checkpoint {
+        Options options {};
+        PngWriter::State state {};
+        std::uint64_t iterations {};
+        double renderSeconds {};
+    };
+
+    // pixels per band when the rows are not given, the band's counts and colors take 32 MiB
+    static constexpr long BandPixels {1L << 22};
+
+    // first line of a checkpoint file, the version goes up whenever its entries change
+    static constexpr const char* CheckpointHeader {"mandelbrot-checkpoint"};
+    static constexpr int CheckpointVersion {3};
+
+private:
+    Options m_options {};
+    Mandelbrot m_mandelbrot {};
+
+    // the view center read from the options
+    BigFloat m_centerRe {};
+    BigFloat m_centerIm {};
+
+    // where the escape counts go while rendering, closed unless the options name a file
+    IterationFile m_data {};
+
+    // private functions
+    bool read_center(std::ostream& errors);
+
+    [[nodiscard]] bool writes_png() const;
+
+    [[nodiscard]] int band_rows() const;
+
+    void set_band(int top);
+
+    bool open_data(std::ostream& errors, int rowsNeeded);
+
+    void store_band(int top, int rows);
+
+    bool write_image(const Framebuffer& framebuffer, std::ostream& out, std::ostream& errors) const;
+
+    int render_frame(std::ostream& out, std::ostream& errors);
+
+    int render_bands(std::ostream& out, std::ostream& errors, const Checkpoint* resumeFrom);
+
+    int recolor(std::ostream& out, std::ostream& errors);
+
+    [[nodiscard]] std::string checkpoint_path() const;
+
+    static bool save_checkpoint(const std::string& path, const Checkpoint& checkpoint);
+
+    static bool load_checkpoint(const std::string& path, Checkpoint& checkpoint);
+
+    void report(std::ostream& out, double renderSeconds, std::uint64_t iterations) const;
+
+public:
+    explicit BatchRenderer(Options options);
+
+    // public functions
+
+    /**
+     * Read the options from the command line, anything not given keeps its default.
+     *
+     * @param errors Receives a message for the first argument that could not be read.
+     * @return Whether every argument was understood.
+     */
+    static bool parse_arguments(int argc, char** argv, Options& options, std::ostream& errors);
+
+    static void print_usage(const char* program, std::ostream& out);
+
+    /**
+     * Render the view and write it to the output file.
+     *
+     * @param out Receives the timing report.
+     * @param errors Receives a message if the view or the output file is rejected.
+     * @return The process exit code, 0 on success.
+     */
+    int run(std::ostream& out, std::ostream& errors);
+};
+
+#endif //SFML_PROJECT_BATCHRENDERER_H
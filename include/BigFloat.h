@@ -0,0 +1,93 @@
+#ifndef SFML_PROJECT_BIGFLOAT_H
+#define SFML_PROJECT_BIGFLOAT_H
+
+#include "DoubleDouble.h"
+#include "FloatExp.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Arbitrary precision fixed point number for view coordinates and reference orbits.
+// The magnitude is stored as 32-bit limbs, most significant first: limb 0 is the integer part and every
+// further limb adds 32 fraction bits. Values must stay below 2^32, which covers everything the escape-time
+// iteration produces before the escape test.
+class BigFloat {
+private:
+    std::vector<std::uint32_t> m_limbs {0};
+    bool m_negative {};
+
+    // private functions
+    static int compare_magnitude(const BigFloat& a, const BigFloat& b);
+
+    static BigFloat add_magnitude(const BigFloat& a, const BigFloat& b);
+
+    static BigFloat subtract_magnitude(const BigFloat& larger, const BigFloat& smaller);
+
+    void normalize_sign();
+
+public:
+    BigFloat() = default;
+
+    explicit BigFloat(long double value, int precision = 2);
+
+    // value * 2^exponent, for offsets below the range of long double
+    BigFloat(long double value, int exponent, int precision);
+
+    // the exact value from its limbs, most significant first, as get_limbs returns them
+    BigFloat(std::vector<std::uint32_t> limbs, bool negative);
+
+    // number of 32-bit fraction limbs needed to resolve the given spacing with 64 guard bits
+    static int precision_for(long double spacing);
+
+    static int precision_for(const FloatExp<long double>& spacing);
+
+    /**
+     * Read a decimal number such as -0.7436438870371587 or 1.5e-30 without going through a binary float,
+     * so coordinates keep every digit given. The integer part has to fit in 32 bits.
+     *
+     * @param text The number, with an optional sign, fraction and decimal exponent.
+     * @param precision Number of 32-bit fraction limbs of the result, digits beyond it are truncated.
+     * @param result Receives the number, left unchanged if the text is not a number.
+     * @return Whether the whole text was a number in range.
+     */
+    static bool parse(const std::string& text, int precision, BigFloat& result);
+
+    // public functions
+
+    [[nodiscard]] int get_precision() const;
+
+    void set_precision(int precision);
+
+    [[nodiscard]] bool is_negative() const;
+
+    [[nodiscard]] const std::vector<std::uint32_t>& get_limbs() const;
+
+    explicit operator long double() const;
+
+    explicit operator double() const;
+
+    explicit operator float() const;
+
+    explicit operator DoubleDouble() const;
+
+    explicit operator FloatExp<long double>() const;
+
+    friend BigFloat operator-(const BigFloat& a);
+
+    friend BigFloat operator+(const BigFloat& a, const BigFloat& b);
+
+    friend BigFloat operator-(const BigFloat& a, const BigFloat& b);
+
+    friend BigFloat operator*(const BigFloat& a, const BigFloat& b);
+
+    BigFloat& operator+=(const BigFloat& other);
+
+    BigFloat& operator-=(const BigFloat& other);
+
+    friend bool operator==(const BigFloat& a, const BigFloat& b);
+
+    friend bool operator!=(const BigFloat& a, const BigFloat& b);
+};
+
+#endif //SFML_PROJECT_BIGFLOAT_H
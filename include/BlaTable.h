@@ -0,0 +1,76 @@
+#ifndef SFML_PROJECT_BLATABLE_H
+#define SFML_PROJECT_BLATABLE_H
+
+#include "Complex.h"
+#include "ReferenceOrbit.h"
+
+#include <vector>
+
+// Bilinear approximations along a reference orbit. While the offset dz is small enough that the dz^2 term
+// vanishes in rounding, a run of iterations collapses into dz' = A dz + B dc. Level l of the table holds
+// one approximation per aligned run of 2^l iterations, so a pixel can skip long, variable-length runs.
+class BlaTable {
+public:
+    struct Step {
+        Complex<double> a;
+        Complex<double> b;
+
+        // the approximation holds while |dz| stays below this radius
+        double radius;
+
+        int length;
+    };
+
+private:
+    // m_levels[l][i] covers the iterations [i * 2^l, (i + 1) * 2^l)
+    std::vector<std::vector<Step>> m_levels {};
+
+    // orbit and largest pixel offset the table was built for
+    unsigned m_generation {};
+    double m_radius {};
+
+    // no run is valid for offsets beyond this, which rules out most lookups without touching the table
+    double m_maxValidRadius {};
+
+public:
+    // relative size of the dropped dz^2 term, the rounding error of double; any coarser and chaotic pixels
+    // drift off their escape counts
+    static constexpr double Epsilon {1.0 / (1LL << 53)};
+
+    // public functions
+    void build(const ReferenceOrbit& reference, double radius);
+
+    [[nodiscard]] bool is_built_for(const ReferenceOrbit& reference, double radius) const;
+
+    void reset();
+
+    /**
+     * Find the longest approximation starting at a reference iteration.
+     *
+     * @param m Reference iteration the pixel is at.
+     * @param dzNorm Squared magnitude of the pixel's current offset.
+     * @param maxLength Number of iterations the pixel may skip at most.
+     * @return The approximation to apply, nullptr if no run of at least two iterations is valid.
+     */
+    [[nodiscard]] const Step* lookup(int m, double dzNorm, int maxLength) const {
+
+        // Runs are aligned, so odd iterations only start single steps
+        if (dzNorm >= m_maxValidRadius * m_maxValidRadius || (m & 1) || m == 0 || maxLength < 2) {
+            return nullptr;
+        }
+
+        // Radii only shrink with the level, so once a run is invalid every longer one is as well
+        const Step* best {nullptr};
+        for (int level = 1; level < static_cast<int>(m_levels.size()) && (m & ((1 << level) - 1)) == 0; ++level) {
+            const auto& steps {m_levels[level]};
+            const size_t index {static_cast<size_t>(m >> level)};
+            if ((1 << level) > maxLength || index >= steps.size() || dzNorm >= steps[index].radius * steps[index].radius) {
+                break;
+            }
+            best = &steps[index];
+        }
+        return best;
+    }
+};
+
+#endif //SFML_PROJECT_BLATABLE_H
@@ -0,0 +1,26 @@
+#ifndef SFML_PROJECT_CANCELLATIONTOKEN_H
+#define SFML_PROJECT_CANCELLATIONTOKEN_H
+
+#include <atomic>
+#include <memory>
+
+// Shared flag telling a render job its result is no longer wanted.
+// Copies share the flag, so the thread that requested the job can cancel it while render threads poll it
+// between units of work. A default constructed token starts out live.
+class CancellationToken {
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled {std::make_shared<std::atomic<bool>>(false)};
+
+public:
+    // public functions
+    void cancel() const {
+        m_cancelled->store(true, std::memory_order_relaxed);
+    }
+
+    // getters
+    [[nodiscard]] bool is_cancelled() const {
+        return m_cancelled->load(std::memory_order_relaxed);
+    }
+};
+
+#endif //SFML_PROJECT_CANCELLATIONTOKEN_H
@@ -0,0 +1,41 @@
+#ifndef SFML_PROJECT_COMPLEX_H
+#define SFML_PROJECT_COMPLEX_H
+
+#include <cmath>
+
+// Minimal complex number over any arithmetic type, std::complex is only specified for the built-in floats.
+template<typename T>
+struct Complex {
+    T re {};
+    T im {};
+
+    friend Complex operator+(const Complex& a, const Complex& b) {
+        return {a.re + b.re, a.im + b.im};
+    }
+
+    friend Complex operator-(const Complex& a, const Complex& b) {
+        return {a.re - b.re, a.im - b.im};
+    }
+
+    friend Complex operator*(const Complex& a, const Complex& b) {
+        return {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+    }
+
+    friend Complex operator*(const Complex& a, const T& scale) {
+        return {a.re * scale, a.im * scale};
+    }
+
+    Complex& operator+=(const Complex& other) { return *this = *this + other; }
+
+    // squared magnitude, cheaper than the magnitude and enough for escape tests
+    [[nodiscard]] T norm() const {
+        return re * re + im * im;
+    }
+
+    [[nodiscard]] T magnitude() const {
+        using std::sqrt;
+        return sqrt(norm());
+    }
+};
+
+#endif //SFML_PROJECT_COMPLEX_H
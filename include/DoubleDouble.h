@@ -0,0 +1,109 @@
+#ifndef SFML_PROJECT_DOUBLEDOUBLE_H
+#define SFML_PROJECT_DOUBLEDOUBLE_H
+
+#include <cmath>
+
+// Unevaluated sum of two doubles, giving about 106 bits of mantissa with the exponent range of double.
+// The error-free transformations below rely on strict IEEE rounding, they only use std::fma when the
+// hardware provides it and fall back to Dekker's splitting otherwise.
+struct DoubleDouble {
+    double hi {};
+    double lo {};
+
+    // rounding error of a single operation
+    static constexpr double epsilon {4.93038065763132e-32};
+
+    constexpr DoubleDouble() = default;
+
+    constexpr DoubleDouble(double value) : hi {value}, lo {} {}
+
+    constexpr DoubleDouble(int value) : hi {static_cast<double>(value)}, lo {} {}
+
+    constexpr DoubleDouble(double high, double low) : hi {high}, lo {low} {}
+
+    // a long double splits exactly into its leading double and the remainder
+    DoubleDouble(long double value) : hi {static_cast<double>(value)}, lo {static_cast<double>(value - hi)} {}
+
+    explicit operator float() const { return static_cast<float>(hi); }
+
+    explicit operator double() const { return hi; }
+
+    explicit operator long double() const { return static_cast<long double>(hi) + lo; }
+
+    static DoubleDouble two_sum(double a, double b) {
+        const double s {a + b};
+        const double bb {s - a};
+        return {s, (a - (s - bb)) + (b - bb)};
+    }
+
+    static DoubleDouble quick_two_sum(double a, double b) {
+        const double s {a + b};
+        return {s, b - (s - a)};
+    }
+
+    static DoubleDouble two_prod(double a, double b) {
+        const double p {a * b};
+#ifdef FP_FAST_FMA
+        return {p, std::fma(a, b, -p)};
+#else
+        const auto split = [](double value, double& high, double& low) {
+            const double t {134217729.0 * value};
+            high = t - (t - value);
+            low = value - high;
+        };
+        double aHi, aLo, bHi, bLo;
+        split(a, aHi, aLo);
+        split(b, bHi, bLo);
+        return {p, ((aHi * bHi - p) + aHi * bLo + aLo * bHi) + aLo * bLo};
+#endif
+    }
+
+    friend DoubleDouble operator+(const DoubleDouble& a, const DoubleDouble& b) {
+        DoubleDouble s {two_sum(a.hi, b.hi)};
+        DoubleDouble t {two_sum(a.lo, b.lo)};
+        s.lo += t.hi;
+        s = quick_two_sum(s.hi, s.lo);
+        s.lo += t.lo;
+        return quick_two_sum(s.hi, s.lo);
+    }
+
+    friend DoubleDouble operator-(const DoubleDouble& a) {
+        return {-a.hi, -a.lo};
+    }
+
+    friend DoubleDouble operator-(const DoubleDouble& a, const DoubleDouble& b) {
+        return a + -b;
+    }
+
+    friend DoubleDouble operator*(const DoubleDouble& a, const DoubleDouble& b) {
+        DoubleDouble p {two_prod(a.hi, b.hi)};
+        p.lo += a.hi * b.lo + a.lo * b.hi;
+        return quick_two_sum(p.hi, p.lo);
+    }
+
+    friend DoubleDouble operator/(const DoubleDouble& a, double b) {
+        const double q1 {a.hi / b};
+        DoubleDouble r {a - two_prod(q1, b)};
+        const double q2 {r.hi / b};
+        r = r - two_prod(q2, b);
+        return quick_two_sum(q1, q2) + r.hi / b;
+    }
+
+    DoubleDouble& operator+=(const DoubleDouble& other) { return *this = *this + other; }
+
+    DoubleDouble& operator-=(const DoubleDouble& other) { return *this = *this - other; }
+
+    friend bool operator>(const DoubleDouble& a, const DoubleDouble& b) {
+        return a.hi > b.hi || (a.hi == b.hi && a.lo > b.lo);
+    }
+
+    friend bool operator<(const DoubleDouble& a, const DoubleDouble& b) {
+        return b > a;
+    }
+
+    friend DoubleDouble abs(const DoubleDouble& a) {
+        return a.hi < 0 ? -a : a;
+    }
+};
+
+#endif //SFML_PROJECT_DOUBLEDOUBLE_H
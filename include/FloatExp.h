@@ -0,0 +1,126 @@
+#ifndef SFML_PROJECT_FLOATEXP_H
+#define SFML_PROJECT_FLOATEXP_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Floating point number with a separate int exponent: value = mantissa * 2^exponent with 0.5 <= |mantissa| < 1.
+// It keeps the speed of the underlying type but never under- or overflows, which perturbation offsets
+// and view sizes need once the pixel spacing leaves the range of double.
+template<typename T>
+struct FloatExp {
+    T mantissa {};
+    int exponent {ZeroExponent};
+
+    // zero sorts below every other exponent, so aligning a sum against zero always keeps the other operand
+    static constexpr int ZeroExponent {std::numeric_limits<int>::min() / 4};
+
+    constexpr FloatExp() = default;
+
+    FloatExp(T value) {
+        int valueExponent {};
+        mantissa = std::frexp(value, &valueExponent);
+        exponent = mantissa == 0 ? ZeroExponent : valueExponent;
+    }
+
+    // mantissa * 2^exponent for an arbitrary mantissa
+    FloatExp(T value, int valueExponent) : FloatExp {value} {
+        if (mantissa != 0) {
+            exponent += valueExponent;
+        }
+    }
+
+    // change of mantissa type, the exponent carries over unchanged
+    template<typename U>
+    explicit FloatExp(const FloatExp<U>& other) : FloatExp {static_cast<T>(other.mantissa), other.exponent} {}
+
+    explicit operator float() const { return static_cast<float>(std::ldexp(mantissa, clamp_exponent())); }
+
+    explicit operator double() const { return static_cast<double>(std::ldexp(mantissa, clamp_exponent())); }
+
+    explicit operator long double() const {
+        return std::ldexp(static_cast<long double>(mantissa), clamp_exponent());
+    }
+
+    // Products of normalized mantissas lie in [0.25, 1), a single doubling normalizes them again
+    friend FloatExp operator*(const FloatExp& a, const FloatExp& b) {
+        FloatExp result {};
+        result.mantissa = a.mantissa * b.mantissa;
+        if (result.mantissa == 0) {
+            return {};
+        }
+        result.exponent = a.exponent + b.exponent;
+        if (std::abs(result.mantissa) < T {0.5}) {
+            result.mantissa *= 2;
+            --result.exponent;
+        }
+        return result;
+    }
+
+    friend FloatExp operator/(const FloatExp& a, T divisor) {
+        return {a.mantissa / divisor, a.exponent};
+    }
+
+    friend FloatExp operator/(const FloatExp& a, const FloatExp& b) {
+        return {a.mantissa / b.mantissa, a.exponent - b.exponent};
+    }
+
+    friend FloatExp operator+(const FloatExp& a, const FloatExp& b) {
+        if (a.exponent < b.exponent) {
+            return b + a;
+        }
+
+        // b vanishes entirely below the rounding of a
+        const int shift {b.exponent - a.exponent};
+        if (shift < -std::numeric_limits<T>::digits - 1) {
+            return a;
+        }
+        return {a.mantissa + std::ldexp(b.mantissa, shift), a.exponent};
+    }
+
+    friend FloatExp operator-(const FloatExp& a) {
+        FloatExp result {a};
+        result.mantissa = -a.mantissa;
+        return result;
+    }
+
+    friend FloatExp operator-(const FloatExp& a, const FloatExp& b) {
+        return a + -b;
+    }
+
+    FloatExp& operator+=(const FloatExp& other) { return *this = *this + other; }
+
+    FloatExp& operator-=(const FloatExp& other) { return *this = *this - other; }
+
+    FloatExp& operator*=(const FloatExp& other) { return *this = *this * other; }
+
+    FloatExp& operator/=(T divisor) { return *this = *this / divisor; }
+
+    friend bool operator<(const FloatExp& a, const FloatExp& b) {
+        return (a - b).mantissa < 0;
+    }
+
+    friend bool operator>(const FloatExp& a, const FloatExp& b) {
+        return b < a;
+    }
+
+    friend FloatExp abs(const FloatExp& a) {
+        return a.mantissa < 0 ? -a : a;
+    }
+
+    friend FloatExp sqrt(const FloatExp& a) {
+
+        // An even exponent halves exactly
+        const int odd {a.exponent & 1};
+        return {std::sqrt(odd ? a.mantissa * 2 : a.mantissa), (a.exponent - odd) / 2};
+    }
+
+private:
+    // ldexp saturates to zero or infinity anyway, keeping the argument small avoids int overflow on zero
+    [[nodiscard]] int clamp_exponent() const {
+        return std::max(exponent, -std::numeric_limits<int>::max() / 8);
+    }
+};
+
+#endif //SFML_PROJECT_FLOATEXP_H
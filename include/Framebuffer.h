@@ -0,0 +1,74 @@
+#ifndef SFML_PROJECT_FRAMEBUFFER_H
+#define SFML_PROJECT_FRAMEBUFFER_H
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <memory>
+
+// RGBA pixels of one frame in a single allocation aligned for the vector units.
+// Rows run top to bottom with four bytes per pixel, the layout sf::Texture::update(const sf::Uint8*) takes,
+// so a frame goes from the coloring pass to the GPU without passing through an sf::Image.
+// Copies are expensive and therefore explicit, see copy_from.
+class Framebuffer {
+public:
+    // a cache line, which also covers the widest vector loads
+    static constexpr std::size_t Alignment {64};
+
+private:
+    struct AlignedDelete {
+        void operator()(sf::Uint8* pixels) const;
+    };
+
+    std::unique_ptr<sf::Uint8[], AlignedDelete> m_pixels {};
+    sf::Vector2i m_size {};
+
+public:
+    Framebuffer() = default;
+
+    explicit Framebuffer(sf::Vector2i size);
+
+    Framebuffer(Framebuffer&&) noexcept = default;
+
+    Framebuffer& operator=(Framebuffer&&) noexcept = default;
+
+    Framebuffer(const Framebuffer&) = delete;
+
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    // public functions
+    void resize(sf::Vector2i size);
+
+    void clear(sf::Color color = sf::Color::Black);
+
+    void copy_from(const Framebuffer& other);
+
+    void set_pixel(int x, int y, const sf::Color& color) {
+        sf::Uint8* pixel {m_pixels.get() + (static_cast<std::size_t>(y) * m_size.x + x) * 4};
+        pixel[0] = color.r;
+        pixel[1] = color.g;
+        pixel[2] = color.b;
+        pixel[3] = color.a;
+    }
+
+    [[nodiscard]] sf::Uint8* row(int y) {
+        return m_pixels.get() + static_cast<std::size_t>(y) * m_size.x * 4;
+    }
+
+    [[nodiscard]] const sf::Uint8* row(int y) const {
+        return m_pixels.get() + static_cast<std::size_t>(y) * m_size.x * 4;
+    }
+
+    // getters
+    [[nodiscard]] sf::Uint8* data();
+
+    [[nodiscard]] const sf::Uint8* data() const;
+
+    [[nodiscard]] sf::Vector2i get_size() const;
+
+    [[nodiscard]] std::size_t get_byte_size() const;
+
+    [[nodiscard]] bool empty() const;
+};
+
+#endif //SFML_PROJECT_FRAMEBUFFER_H
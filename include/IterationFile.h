@@ -0,0 +1,111 @@
+#ifndef SFML_PROJECT_ITERATIONFILE_H
+#define SFML_PROJECT_ITERATIONFILE_H
+
+#include "BigFloat.h"
+#include "MappedFile.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+#include <string>
+
+// The raw results of a render in a binary file, so it can be recolored or analysed without rendering again.
+// A fixed header holds the view: the center with every limb it was read with, the span and the iteration
+// limit, and how many rows are stored so far. Each channel follows as one plane of 32-bit values, row by
+// row and aligned to a page, so a mapped file is read in place without copying or decoding:
+//   Iterations  escape count per pixel, the limit or more for points that did not escape
+//   Smooth      fraction of the escape count in [0, 1], for smooth coloring
+// Values are stored in the byte order of the machine that wrote them, a file from the other order is
+// rejected. The version goes up whenever the layout changes.
+class IterationFile {
+public:
+    enum Channel : std::uint32_t {
+        Iterations = 1,
+        Smooth = 2
+    };
+
+    // the render parameters, enough to render the same pixels again
+    struct View {
+        BigFloat centerRe {};
+        BigFloat centerIm {};
+
+        // width of the view on the complex plane
+        long double span {};
+
+        int maxIterations {};
+        sf::Vector2i size {};
+    };
+
+    static constexpr std::uint32_t Version {2};
+    static constexpr int ChannelCount {2};
+
+    // channels start on a page, so they can be mapped and prefetched on their own
+    static constexpr std::uint64_t ChannelAlignment {4096};
+
+private:
+    MappedFile m_file {};
+    View m_view {};
+    std::uint32_t m_channels {};
+    int m_rowsWritten {};
+
+    // byte offset of every channel in the file, 0 for those it does not hold
+    std::uint64_t m_offsets[ChannelCount] {};
+
+    // private functions
+    bool read_header();
+
+    [[nodiscard]] const std::uint8_t* channel(Channel channel) const;
+
+    [[nodiscard]] std::uint8_t* channel(Channel channel);
+
+public:
+    // public functions
+
+    /**
+     * Create the file for the given view, every pixel of every channel starts at zero.
+     *
+     * @param channels The channels to store, a combination of Channel values.
+     * @return Whether the file could be created at its full size.
+     */
+    bool create(const std::string& path, const View& view, std::uint32_t channels);
+
+    /**
+     * Map a file written earlier.
+     *
+     * @param writable Whether rows are written to it, to finish a render that was stopped.
+     * @return Whether the file exists and is a file of this version.
+     */
+    bool open(const std::string& path, bool writable = false);
+
+    /**
+     * Store the results of a band of rows, the rows are copied on all cores.
+     *
+     * @param top First row of the band in the image.
+     * @param rows Number of rows, each as wide as the image.
+     * @param iterations Escape counts of the band.
+     * @param fractions Smooth fractions of the band, ignored if the file has no Smooth channel.
+     */
+    void write_rows(int top, int rows, const int* iterations, const float* fractions);
+
+    // write the stored rows and the header to disk, returns once they are there
+    bool flush();
+
+    void close();
+
+    // getters
+    [[nodiscard]] const View& get_view() const;
+
+    [[nodiscard]] bool has_channel(Channel channel) const;
+
+    [[nodiscard]] bool is_open() const;
+
+    // rows from the top that are stored, the height once the render finished
+    [[nodiscard]] int get_rows_written() const;
+
+    // the channels of the mapped file, row by row, null for channels the file does not hold
+    [[nodiscard]] const std::int32_t* get_iterations() const;
+
+    [[nodiscard]] const float* get_fractions() const;
+};
+
+#endif //SFML_PROJECT_ITERATIONFILE_H
@@ -5,38 +5,259 @@
 #ifndef SFML_PROJECT_MADNELBROT_H
 #define SFML_PROJECT_MADNELBROT_H
 
+#include "BigFloat.h"
+#include "BlaTable.h"
+#include "CancellationToken.h"
+#include "DoubleDouble.h"
+#include "FloatExp.h"
+#include "Framebuffer.h"
+#include "Palette.h"
+#include "ReferenceOrbit.h"
+#include "SeriesApproximation.h"
+#include "SimdKernel.h"
+#include "TileCache.h"
+#include "TileScheduler.h"
+
 #include <SFML/Graphics.hpp>
 #include <cassert>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
 
 class Mandelbrot {
+public:
+    // arithmetic tiers, from the cheapest to the most precise
+    enum class Precision {
+        Float,
+        Double,
+        LongDouble,
+        DoubleDouble,
+        Perturbation
+    };
+
+    // called on the rendering thread once a preview pass of the frame is in the image
+    using PassCallback = std::function<void()>;
+
 private:
-    using PrecisionType = long double;
+    // one pass of a progressive frame: the pixels on a grid of the given spacing, each filling the block
+    // to its bottom right until a finer pass gets there
+    struct Pass {
+        int step;
+
+        // the pixels on the grid of the previous pass, twice as coarse, are already done
+        bool refines;
+
+        // steps are powers of two, so a grid pixel lies on the coarser grid unless x or y has the step's bit set
+        [[nodiscard]] bool computes(int x, int y) const {
+            return !refines || ((x | y) & step) != 0;
+        }
+    };
+
+    // a cache tile overlapping the frame, at the frame pixel its top left corner lands on
+    struct GridTile {
+        TileCache::Tile* tile;
+        int x;
+        int y;
+    };
+
+    // pixel still running at the iteration limit, with the orbit to continue it from
+    struct PendingPixel {
+        int index;
+        SimdKernel::Orbit<double> orbit;
+    };
+
+    // the view center is kept in arbitrary precision so deep views stay addressable
+    using CoordType = BigFloat;
+
+    // view sizes and pixel offsets carry their own exponent so they never underflow, however deep the view
+    using SpanType = FloatExp<long double>;
+    using DeltaType = FloatExp<double>;
+
+    // pixel positions shared by the views cached so far: pixel (px, py) lies at min + (px, py) * spacing,
+    // where min is the top left pixel of the view that was cached first
+    struct Lattice {
+        std::uint64_t id;
+        CoordType minRe;
+        CoordType minIm;
+        SpanType spacingRe;
+        SpanType spacingIm;
+    };
 
-    sf::Image m_image {};
-    sf::Texture m_texture {};
-    sf::Sprite m_sprite {};
+    // colors of the last frame, written in place by the coloring pass
+    Framebuffer m_framebuffer {};
 
     int m_width {};
     int m_height {};
     long double m_zoom {};
 
-    PrecisionType m_minRe {};
-    PrecisionType m_maxRe {};
+    CoordType m_centerRe {};
+    CoordType m_centerIm {};
 
-    PrecisionType m_minIm {};
-    PrecisionType m_maxIm {};
+    // width and height of the view on the complex plane
+    SpanType m_spanRe {};
+    SpanType m_spanIm {};
 
     int m_maxIterations {};
 
+    // tier used for the last frame
+    Precision m_precision {};
+
+    // answer points in the main cardioid and the period-2 bulb without iterating, only valid for z^2 + c
+    bool m_interiorCheck {true};
+
+    // stop iterating bounded points once their orbit repeats within the rounding of the working precision
+    bool m_periodicityCheck {true};
+
+    // render views beyond long double as offsets from a reference orbit instead of in double-double
+    bool m_perturbation {true};
+    ReferenceOrbit m_reference {};
+
+    // let every pixel skip the iterations a truncated power series in its offset can predict
+    bool m_seriesApproximation {true};
+    SeriesApproximation m_series {};
+
+    // skip runs of iterations where the offset is still linear, tables are kept while the reference is reused
+    bool m_bilinearApproximation {true};
+    BlaTable m_bla {};
+
+    // re-render pixels that fail the glitch criterion against extra references placed inside the glitches
+    static constexpr int MaxGlitchReferences {8};
+    static constexpr int GlitchTileSize {32};
+    bool m_glitchCorrection {true};
+    int m_glitchReferences {};
+
+    Palette m_palette {};
+
+    // frames are rendered as square tiles on a persistent work-stealing thread pool
+    static constexpr int TileSize {32};
+    TileScheduler m_scheduler {};
+
+    // render every 4th pixel in both directions first, then every 2nd, then the rest, so a preview at
+    // 1/16 and 1/4 of the pixels is ready after a fraction of the frame time; the step divides TileSize
+    static constexpr int CoarsestStep {4};
+    bool m_progressive {true};
+
+    // escape counts of the last frame, so a new iteration limit or a pan continues from them; pixels a
+    // pan exposed or a cancelled frame never reached are missing, the limit is 0 once the view changed
+    // in a way the counts cannot follow
+    static constexpr int Missing {-1};
+    std::vector<int> m_iterations {};
+    int m_iterationsLimit {};
+    sf::Vector2i m_iterationsScreen {};
+    Precision m_iterationsPrecision {};
+
+    // fraction of the escape count for every pixel, only kept while smooth coloring is on
+    bool m_smoothColoring {};
+    std::vector<float> m_fractions {};
+
+    // pans and zoom outs this close to a whole number of pixels move the stored counts along
+    static constexpr long double PixelTolerance {1e-6L};
+
+    // pixels still running at that limit, only the vector tiers keep their orbits and can be resumed
+    static constexpr int ResumeBatch {1024};
+    std::vector<PendingPixel> m_pending {};
+    std::mutex m_pendingMutex {};
+    bool m_resumable {};
+
+    // finished pixels are kept in tiles on the pixel lattices of the views they were rendered for, so a view
+    // that comes back, or any view lying on the same lattice, renders from memory; views are never moved
+    bool m_tileCaching {true};
+    TileCache m_tileCache {};
+
+    // lattices of the cached views, most recently used first, the tiles of a dropped one age out of the cache
+    static constexpr size_t MaxLattices {64};
+    std::vector<Lattice> m_lattices {};
+    std::uint64_t m_nextLattice {};
+
+    // views further than this many pixels from a lattice's first view start a lattice of their own
+    static constexpr long double MaxLatticeOffset {1LL << 40};
+
+    // lattice of the current frame and the lattice index of its top left pixel
+    std::uint64_t m_gridLattice {};
+    std::int64_t m_gridX {};
+    std::int64_t m_gridY {};
+
+    // a band of a frame too large to render at once: the screen's rows start at row m_bandTop of a frame
+    // m_frameHeight rows tall that the view covers, the screen is the whole view while the height is 0
+    int m_bandTop {};
+    int m_frameHeight {};
+
+    // a zoom stretches the last frame over the new view right away, so there is something to show until
+    // the first pass of the new frame lands
+    bool m_preview {};
 
     // private functions
-    void init_variables();
+    void update_precision();
+
+    [[nodiscard]] CoordType to_coord(long double value) const;
+
+    [[nodiscard]] CoordType to_coord(const SpanType& value) const;
+
+    [[nodiscard]] Precision select_precision(sf::Vector2i screen) const;
+
+    [[nodiscard]] unsigned kernel_flags() const;
+
+    void set_result(int iters, int x, int y, sf::Vector2i screen, double norm = 0.0);
+
+    [[nodiscard]] static float smooth_fraction(double norm);
+
+    [[nodiscard]] bool is_missing(int x, int y, sf::Vector2i screen) const;
+
+    [[nodiscard]] int frame_height(sf::Vector2i screen) const;
+
+    void invalidate_iterations();
+
+    void find_lattice(sf::Vector2i screen);
+
+    [[nodiscard]] std::uint32_t tile_formula() const;
+
+    std::vector<GridTile> grid_tiles(sf::Vector2i screen, bool create);
+
+    void fill_from_cache(sf::Vector2i screen);
+
+    void store_in_cache(sf::Vector2i screen);
+
+    void remap_iterations(long double fractionX, long double fractionY, long double scale);
+
+    void move_center(long double fractionX, long double fractionY);
+
+    bool reuse_iterations(sf::Vector2i screen, const CancellationToken& cancel);
+
+    void colorize(sf::Vector2i screen, int step = 1);
+
+    void render_missing(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass);
+
+    void reproject_image(long double fractionX, long double fractionY, long double zoomFactor);
+
+    template<typename T>
+    void resume_simd(sf::Vector2i screen, const CancellationToken& cancel);
+
+    void run_passes(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass,
+                    const std::function<void(const TileScheduler::Tile&, const Pass&)>& work);
+
+    template<typename T>
+    void mandy_simd(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass);
+
+    template<typename T>
+    void mandy_scalar(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass);
+
+    void mandy_perturbation(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass);
+
+    void correct_glitches(sf::Vector2i screen, std::vector<int>& pixels,
+                          DeltaType minRe, DeltaType minIm, DeltaType spanRe, DeltaType spanIm,
+                          const CancellationToken& cancel);
 
 public:
     Mandelbrot();
 
     // public functions
-    void mandy(sf::Vector2i screen);
+    void mandy(sf::Vector2i screen, const CancellationToken& cancel = {}, const PassCallback& onPass = {});
+
+    void zoom_at(long double fractionX, long double fractionY, long double zoomFactor);
+
+    void move(long double fractionX, long double fractionY);
 
     //accessor functions
     // setters
@@ -52,8 +273,36 @@ public:
 
     void set_max_im(long double maxIm);
 
+    void set_center(const BigFloat& centerRe, const BigFloat& centerIm);
+
+    void set_span(long double spanRe, long double spanIm);
+
+    void set_band(int top, int frameHeight);
+
     void set_max_iterations(int maxIterations);
 
+    void set_exact_palette(bool exact);
+
+    void set_palette_offset(double offset);
+
+    void set_smooth_coloring(bool smoothColoring);
+
+    void set_interior_check(bool interiorCheck);
+
+    void set_periodicity_check(bool periodicityCheck);
+
+    void set_perturbation(bool perturbation);
+
+    void set_series_approximation(bool seriesApproximation);
+
+    void set_bilinear_approximation(bool bilinearApproximation);
+
+    void set_glitch_correction(bool glitchCorrection);
+
+    void set_progressive(bool progressive);
+
+    void set_tile_cache(bool tileCache);
+
     // getters
     long double get_zoom() const;
 
@@ -67,12 +316,43 @@ public:
 
     int get_max_iterations() const;
 
-    sf::Image get_image();
+    std::uint64_t get_iteration_count() const;
+
+    bool is_exact_palette() const;
+
+    double get_palette_offset() const;
+
+    bool is_smooth_coloring() const;
+
+    bool is_interior_check() const;
+
+    bool is_periodicity_check() const;
+
+    bool is_perturbation() const;
+
+    bool is_series_approximation() const;
+
+    bool is_bilinear_approximation() const;
+
+    bool is_glitch_correction() const;
+
+    bool is_progressive() const;
+
+    bool is_tile_cache() const;
+
+    bool has_preview() const;
+
+    Precision get_precision() const;
+
+    std::string get_precision_name() const;
+
+    const Framebuffer& get_framebuffer() const;
 
-    // interpolation functions
-    static sf::Color linear_interp(const sf::Color& color1, const sf::Color& color2, double ratio);
+    // escape counts of the last frame row by row, -1 for pixels the frame did not get to
+    const std::vector<int>& get_iterations() const;
 
-    static sf::Color interpolate_color(double colorIndex, const std::vector<sf::Color> &colors);
+    // smooth fractions in the same layout, empty unless smooth coloring is on
+    const std::vector<float>& get_fractions() const;
 };
 
 #endif //SFML_PROJECT_MADNELBROT_H
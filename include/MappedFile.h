@@ -0,0 +1,69 @@
+#ifndef SFML_PROJECT_MAPPEDFILE_H
+#define SFML_PROJECT_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A file mapped into memory as a whole, either created at a fixed size for writing or opened read-only.
+// Pages are only read from or written to disk as they are touched, so files far larger than memory can be
+// filled or read in place, and several threads can write disjoint parts of the mapping at once.
+class MappedFile {
+private:
+    std::uint8_t* m_data {};
+    std::size_t m_size {};
+    bool m_writable {};
+
+#ifdef _WIN32
+    void* m_file {};
+    void* m_mapping {};
+#else
+    int m_file {-1};
+#endif
+
+    // private functions
+    bool map(std::size_t size, bool writable);
+
+public:
+    MappedFile() = default;
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // public functions
+
+    /**
+     * Create the file, or cut an existing one, at the given size and map it for writing. New bytes read
+     * as zero.
+     *
+     * @return Whether the file could be created and mapped.
+     */
+    bool create(const std::string& path, std::size_t size);
+
+    /**
+     * Map an existing file.
+     *
+     * @param writable Whether the mapping is written to, the file keeps its size either way.
+     * @return Whether the file exists and could be mapped.
+     */
+    bool open(const std::string& path, bool writable = false);
+
+    // write the changed pages to disk, returns once they are there
+    bool flush();
+
+    void close();
+
+    // getters
+    [[nodiscard]] std::uint8_t* data();
+
+    [[nodiscard]] const std::uint8_t* data() const;
+
+    [[nodiscard]] std::size_t get_size() const;
+
+    [[nodiscard]] bool is_open() const;
+};
+
+#endif //SFML_PROJECT_MAPPEDFILE_H
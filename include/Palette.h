@@ -0,0 +1,91 @@
+#ifndef SFML_PROJECT_PALETTE_H
+#define SFML_PROJECT_PALETTE_H
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+class Palette {
+private:
+    // gradient stops the lookup table is interpolated from
+    std::vector<sf::Color> m_colors {};
+
+    // precomputed color for every table slot
+    std::vector<sf::Color> m_table {};
+
+    // iteration limit the table was built for (0 means the table is stale)
+    int m_maxIterations {};
+
+    // when set, the table has one slot per iteration so colors match the gradient exactly
+    bool m_exact {};
+
+    // rotation of the gradient as a fraction of its length, and the same in table slots
+    double m_offset {};
+    int m_shift {};
+
+    // private functions
+    void update_shift();
+
+public:
+    // number of slots used when the table is not exact; 4096 colors are 16 KiB and stay in L1
+    static constexpr int TableSize {4096};
+
+    Palette();
+
+    // public functions
+    void build(int maxIterations);
+
+    [[nodiscard]] bool is_built_for(int maxIterations) const;
+
+    /**
+     * Look up the color of a point that escaped after the given number of iterations.
+     * Points that reached the iteration limit take the color of slot 0 whatever the offset.
+     */
+    [[nodiscard]] const sf::Color& color(int iters) const {
+        if (iters >= m_maxIterations) {
+            return m_table[0];
+        }
+        const auto size {static_cast<long long>(m_table.size())};
+        auto slot {iters * size / m_maxIterations + m_shift};
+        if (slot >= size) {
+            slot -= size;
+        }
+        return m_table[static_cast<size_t>(slot)];
+    }
+
+    /**
+     * Same for a smooth escape count, iters plus a fraction in [0, 1), blending the two nearest slots.
+     */
+    [[nodiscard]] sf::Color color(int iters, float fraction) const {
+        if (iters >= m_maxIterations) {
+            return m_table[0];
+        }
+        const auto size {static_cast<long long>(m_table.size())};
+        const double position {(iters + static_cast<double>(fraction)) * size / m_maxIterations};
+        const auto lower {static_cast<long long>(position)};
+        const long long slot {(lower + m_shift) % size};
+        return linear_interp(m_table[static_cast<size_t>(slot)], m_table[static_cast<size_t>((slot + 1) % size)],
+                             position - lower);
+    }
+
+    // setters
+    void set_colors(const std::vector<sf::Color>& colors);
+
+    void set_exact(bool exact);
+
+    void set_offset(double offset);
+
+    // getters
+    [[nodiscard]] const std::vector<sf::Color>& get_colors() const;
+
+    [[nodiscard]] bool is_exact() const;
+
+    [[nodiscard]] double get_offset() const;
+
+    // interpolation functions
+    static sf::Color linear_interp(const sf::Color& color1, const sf::Color& color2, double ratio);
+
+    static sf::Color interpolate_color(double colorIndex, const std::vector<sf::Color>& colors);
+};
+
+#endif //SFML_PROJECT_PALETTE_H
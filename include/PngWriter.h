@@ -0,0 +1,86 @@
+#ifndef SFML_PROJECT_PNGWRITER_H
+#define SFML_PROJECT_PNGWRITER_H
+
+#include "Framebuffer.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Writes a PNG file a band of rows at a time, so images far larger than memory can be encoded.
+// Every band is filtered and then deflated in independent pieces on all cores; each piece ends on a byte
+// boundary with an empty stored block, so the pieces join into the one zlib stream PNG expects. Only the
+// last row of the previous band is kept, as the filters of the next band refer to it.
+// The image is stored as 8-bit RGB, the alpha channel of the framebuffer is dropped.
+class PngWriter {
+public:
+    // how far the file got after the last band, enough to append to it again in a later process
+    struct State {
+        std::uint64_t bytes {};
+        int rows {};
+        std::uint32_t adler {};
+        std::vector<std::uint8_t> previousRow {};
+    };
+
+private:
+    std::ofstream m_file {};
+    sf::Vector2i m_size {};
+    int m_rowsWritten {};
+
+    // running checksum of the uncompressed stream, it closes the zlib stream
+    std::uint32_t m_adler {1};
+
+    // RGB of the last row written, zero before the first
+    std::vector<std::uint8_t> m_previousRow {};
+
+    // private functions
+    bool write_chunk(const char* type, const std::uint8_t* data, std::size_t size);
+
+public:
+    // uncompressed bytes per piece deflated on its own, larger pieces compress slightly better
+    static constexpr std::size_t PieceSize {1 << 20};
+
+    // public functions
+
+    /**
+     * Create the file and write the header for an image of the given size.
+     *
+     * @return Whether the file could be written.
+     */
+    bool open(const std::string& path, sf::Vector2i size);
+
+    /**
+     * Append the rows of a band below the rows written so far.
+     *
+     * @param band Rows as wide as the image, the band must not reach past its bottom.
+     * @return Whether the rows could be written.
+     */
+    bool write_rows(const Framebuffer& band);
+
+    /**
+     * Continue a file left behind by an earlier writer. Whatever was written after the state was taken
+     * is cut off, the next band goes right after the rows the state covers.
+     *
+     * @param state The state taken from the earlier writer, for an image of the given size.
+     * @return Whether the file is at least as long as the state says and could be opened.
+     */
+    bool resume(const std::string& path, sf::Vector2i size, const State& state);
+
+    /**
+     * End the zlib stream and the file, once every row of the image is written.
+     *
+     * @return Whether the file is complete and was flushed without errors.
+     */
+    bool close();
+
+    // getters
+    [[nodiscard]] int get_rows_written() const;
+
+    // flushes the file, so the state covers bytes that are on disk
+    [[nodiscard]] State get_state();
+};
+
+#endif //SFML_PROJECT_PNGWRITER_H
@@ -0,0 +1,94 @@
+#ifndef SFML_PROJECT_REFERENCEORBIT_H
+#define SFML_PROJECT_REFERENCEORBIT_H
+
+#include "BigFloat.h"
+#include "CancellationToken.h"
+#include "FloatExp.h"
+
+#include <limits>
+#include <vector>
+
+class BlaTable;
+
+// Orbit of a single reference point, iterated in arbitrary precision and stored rounded to double.
+// Every other pixel is iterated as a small offset from this orbit (perturbation), which only needs
+// double precision no matter how deep the view is.
+class ReferenceOrbit {
+public:
+    struct Point {
+        double re;
+        double im;
+    };
+
+private:
+    // Z_0 .. Z_n, ending at the first point outside the escape radius or at the iteration limit
+    std::vector<Point> m_orbit {};
+
+    BigFloat m_re {};
+    BigFloat m_im {};
+
+    int m_maxIterations {};
+
+    // changes whenever the orbit is recomputed, tables derived from the orbit compare against it
+    unsigned m_generation {};
+
+    // iterations between checks of the cancellation token
+    static constexpr int CancelInterval {1024};
+
+    // private functions
+    [[nodiscard]] int iterate_from(int m, int iters, double dcRe, double dcIm, int maxIterations,
+                                   double dzRe, double dzIm, const BlaTable* bla, bool* glitched, double* escapeNorm) const;
+
+public:
+    // Pauldelbrot's criterion: once |Z + dz|^2 falls below this fraction of |Z|^2, the offset has cancelled
+    // most of the reference and the double rounding of Z dominates the result
+    static constexpr double GlitchTolerance {1e-6};
+
+    // offsets below 2^DeltaExponentLimit are iterated as FloatExp, 64 bits above the smallest normal double
+    static constexpr int DeltaExponentLimit {std::numeric_limits<double>::min_exponent + 64};
+
+    // public functions
+    // a cancelled computation leaves the orbit empty
+    void compute(const BigFloat& re, const BigFloat& im, int maxIterations, const CancellationToken& cancel = {});
+
+    /**
+     * Iterate a pixel given by its offset from the reference point.
+     *
+     * @param dcRe Real part of the offset.
+     * @param dcIm Imaginary part of the offset.
+     * @param maxIterations Iteration limit, at most the limit the orbit was computed for.
+     * @param skip Iteration to start from, with the offset already advanced to it.
+     * @param dzRe Real part of the offset at the start iteration.
+     * @param dzIm Imaginary part of the offset at the start iteration.
+     * @param bla Bilinear approximations of this orbit used to skip iterations, may be nullptr.
+     * @param glitched Set when the pixel is detected as glitched, may be nullptr to skip detection.
+     * @param escapeNorm Receives |z|^2 at the iteration the pixel escaped, 0 if it did not, may be nullptr.
+     * @return The escape iteration, maxIterations for bounded points, meaningless if glitched was set.
+     */
+    [[nodiscard]] int iterate(double dcRe, double dcIm, int maxIterations,
+                              int skip = 0, double dzRe = 0.0, double dzIm = 0.0,
+                              const BlaTable* bla = nullptr, bool* glitched = nullptr,
+                              double* escapeNorm = nullptr) const;
+
+    // same for offsets of any magnitude, starting at the first iteration
+    [[nodiscard]] int iterate(FloatExp<double> dcRe, FloatExp<double> dcIm, int maxIterations,
+                              const BlaTable* bla = nullptr, bool* glitched = nullptr,
+                              double* escapeNorm = nullptr) const;
+
+    [[nodiscard]] bool is_empty() const;
+
+    // getters
+    [[nodiscard]] const BigFloat& get_re() const;
+
+    [[nodiscard]] const BigFloat& get_im() const;
+
+    [[nodiscard]] int get_max_iterations() const;
+
+    [[nodiscard]] int get_precision() const;
+
+    [[nodiscard]] unsigned get_generation() const;
+
+    [[nodiscard]] const std::vector<Point>& get_orbit() const;
+};
+
+#endif //SFML_PROJECT_REFERENCEORBIT_H
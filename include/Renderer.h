@@ -0,0 +1,92 @@
+#ifndef SFML_PROJECT_RENDERER_H
+#define SFML_PROJECT_RENDERER_H
+
+#include "CancellationToken.h"
+#include "Framebuffer.h"
+#include "Mandelbrot.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs Mandelbrot::mandy on a thread of its own so the window keeps handling events while a frame is computed.
+// The window never touches the Mandelbrot object directly: view changes are posted as commands and applied
+// by the render thread before its next frame. Posting a command cancels the frame in flight, so only the newest
+// view ever keeps the render threads busy. Finished pixels are copied once into a framebuffer of the renderer,
+// which the window uploads straight to its texture while the render thread keeps coloring its own one.
+class Renderer {
+public:
+    using Command = std::function<void(Mandelbrot&)>;
+
+    // the view a finished frame shows, its pixels go to the window's texture
+    struct Frame {
+        int maxIterations {};
+        long double zoom {};
+        std::string precisionName {};
+    };
+
+private:
+    Mandelbrot& m_mandelbrot;
+    sf::Vector2i m_screen {};
+
+    // commands posted since the last frame started
+    std::mutex m_commandMutex {};
+    std::condition_variable m_wake {};
+    std::vector<Command> m_commands {};
+    bool m_dirty {true};
+    bool m_stop {};
+
+    // token of the frame being rendered, replaced at the start of every frame
+    CancellationToken m_cancel {};
+
+    // last finished frame, the generation tells the window whether it already has it
+    mutable std::mutex m_frameMutex {};
+    Frame m_frame {};
+    Framebuffer m_framebuffer {};
+    unsigned m_frameGeneration {};
+
+    // the next frame is copied here outside the lock, then swapped with the published one
+    Framebuffer m_backBuffer {};
+
+    std::atomic<bool> m_busy {};
+    std::thread m_thread {};
+
+    // private functions
+    void render_loop();
+
+    void publish_frame();
+
+public:
+    Renderer(Mandelbrot& mandelbrot, sf::Vector2i screen);
+
+    ~Renderer();
+
+    Renderer(const Renderer&) = delete;
+
+    Renderer& operator=(const Renderer&) = delete;
+
+    // public functions
+    void post(Command command);
+
+    /**
+     * Upload the last finished frame if it is newer than the one the caller has.
+     * Call it from the thread that owns the texture's OpenGL context.
+     *
+     * @param frame Receives the view of the frame.
+     * @param generation Generation of the caller's frame, updated when a newer frame was uploaded.
+     * @param texture Receives the pixels, it is recreated if its size does not match the frame.
+     * @return Whether a newer frame was uploaded.
+     */
+    bool fetch_frame(Frame& frame, unsigned& generation, sf::Texture& texture) const;
+
+    // getters
+    [[nodiscard]] bool is_busy() const;
+};
+
+#endif //SFML_PROJECT_RENDERER_H
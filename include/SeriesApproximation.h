@@ -0,0 +1,47 @@
+#ifndef SFML_PROJECT_SERIESAPPROXIMATION_H
+#define SFML_PROJECT_SERIESAPPROXIMATION_H
+
+#include "Complex.h"
+#include "ReferenceOrbit.h"
+
+#include <vector>
+
+// Truncated power series of the perturbation offset in the pixel offset: dz_n = sum_k A_k,n dc^k.
+// All pixels of a view follow nearly the same path early on, so the series lets every pixel start at
+// iteration N with a few multiplications instead of N perturbation steps.
+// Coefficients are stored scaled by the view radius r (a_k = A_k r^k) so they stay in double range.
+class SeriesApproximation {
+private:
+    // a_1 .. a_order at the skip iteration
+    std::vector<Complex<double>> m_coefficients {};
+
+    // largest pixel offset of the view
+    double m_radius {};
+
+    // iteration every pixel starts from
+    int m_skip {};
+
+    int m_order {16};
+
+public:
+    // the omitted terms may shift a pixel by at most this fraction of the offset between neighbouring pixels,
+    // looser bounds skip only a handful more iterations but visibly change boundary pixels
+    static constexpr double Tolerance {1e-9};
+
+    // public functions
+    void compute(const ReferenceOrbit& reference, double radius, double spacing, int maxIterations);
+
+    void evaluate(double dcRe, double dcIm, double& dzRe, double& dzIm) const;
+
+    void reset();
+
+    // setters
+    void set_order(int order);
+
+    // getters
+    [[nodiscard]] int get_skip() const;
+
+    [[nodiscard]] int get_order() const;
+};
+
+#endif //SFML_PROJECT_SERIESAPPROXIMATION_H
@@ -0,0 +1,207 @@
+#ifndef SFML_PROJECT_SIMDKERNEL_H
+#define SFML_PROJECT_SIMDKERNEL_H
+
+#include <cmath>
+#include <limits>
+
+// Escape-time kernels that iterate several pixels at once.
+// The instruction set is picked at runtime, every variant returns the same iteration counts.
+class SimdKernel {
+public:
+    enum class Isa {
+        Scalar,
+        Avx2,
+        Avx512
+    };
+
+    // best instruction set supported by the running CPU
+    static Isa detect();
+
+    // instruction set used by escape_time, defaults to detect()
+    static Isa get_isa();
+
+    // force a specific instruction set, falls back to the best supported one
+    static void set_isa(Isa isa);
+
+    static const char* isa_name(Isa isa);
+
+    // shortcuts that are only valid for z^2 + c, combined as a bit mask
+    enum Flags : unsigned {
+        None = 0,
+
+        // report points inside the main cardioid or the period-2 bulb as bounded without iterating
+        SkipInterior = 1u << 0,
+
+        // report orbits that return to an earlier point (Brent's cycle detection) as bounded
+        DetectPeriod = 1u << 1
+    };
+
+    // Brent's method compares against the point saved at the last power of two iteration, starting here
+    static constexpr int FirstCheckpoint {8};
+
+    // reported instead of the iteration limit for points proven bounded when orbits are kept,
+    // they stay bounded under any higher limit
+    static constexpr int Settled {std::numeric_limits<int>::max()};
+
+    // state of a pixel that reached the iteration limit, enough to continue it under a higher limit
+    // exactly as if it had never stopped
+    template<typename T>
+    struct Orbit {
+        T re;
+        T im;
+        T savedRe;
+        T savedIm;
+    };
+
+    /**
+     * Distance |dx| + |dy| below which two orbit points count as equal: a few units of the working
+     * precision's rounding, orbits in the escape radius have magnitude below 2.
+     */
+    template<typename T>
+    static T period_tolerance() {
+        if constexpr (std::numeric_limits<T>::is_specialized) {
+            return std::numeric_limits<T>::epsilon() * 16;
+        } else {
+            return T {T::epsilon * 16};
+        }
+    }
+
+    // next iteration to save the orbit point at, stays in range of int for any iteration limit
+    static int next_checkpoint(int checkpoint, int maxIterations) {
+        return checkpoint > maxIterations / 2 ? maxIterations : checkpoint * 2;
+    }
+
+    // checkpoint an uninterrupted run is waiting for when it reaches the given iteration
+    static int resume_checkpoint(int startIteration, int maxIterations) {
+        int checkpoint {FirstCheckpoint};
+        while (checkpoint < startIteration) {
+            checkpoint = next_checkpoint(checkpoint, maxIterations);
+        }
+        return checkpoint;
+    }
+
+    /**
+     * Iterate z = z^2 + c for a run of pixels. Lanes finish together, so pixels close to each other on the
+     * plane, whose orbits take similar iteration counts, should be passed next to each other.
+     *
+     * @param realCoords Real coordinates of the pixels.
+     * @param imagCoords Imaginary coordinates of the pixels.
+     * @param count Number of pixels.
+     * @param maxIterations Iteration limit.
+     * @param iterations Receives the escape iteration of every pixel, maxIterations for bounded points.
+     * @param flags Shortcuts to apply, see Flags.
+     * @param orbits When given, pixels reaching the limit leave their orbit here and pixels proven bounded
+     *               report Settled instead of the limit.
+     * @param startIteration When above 0, every pixel continues from its orbit, which a run with this limit
+     *                       and the same flags left there.
+     * @param norms When given, receives |z|^2 of every pixel at the iteration it escaped, 0 for the others.
+     */
+    static void escape_time(const double* realCoords, const double* imagCoords, int count, int maxIterations, int* iterations,
+                            unsigned flags = None, Orbit<double>* orbits = nullptr, int startIteration = 0,
+                            double* norms = nullptr);
+
+    // single precision variant, twice as many pixels per register
+    static void escape_time(const float* realCoords, const float* imagCoords, int count, int maxIterations, int* iterations,
+                            unsigned flags = None, Orbit<float>* orbits = nullptr, int startIteration = 0,
+                            float* norms = nullptr);
+
+    static void escape_time_scalar(const double* realCoords, const double* imagCoords, int count, int maxIterations, int* iterations,
+                                   unsigned flags = None, Orbit<double>* orbits = nullptr, int startIteration = 0,
+                                   double* norms = nullptr);
+
+    static void escape_time_scalar(const float* realCoords, const float* imagCoords, int count, int maxIterations, int* iterations,
+                                   unsigned flags = None, Orbit<float>* orbits = nullptr, int startIteration = 0,
+                                   float* norms = nullptr);
+
+    /**
+     * Closed form membership test for the two largest components of the interior.
+     * Main cardioid: q (q + x - 1/4) <= y^2 / 4 with q = (x - 1/4)^2 + y^2, period-2 bulb: (x + 1)^2 + y^2 <= 1/16.
+     */
+    template<typename T>
+    static bool is_interior(T realCoord, T imagCoord) {
+        const T imagSquare {imagCoord * imagCoord};
+        const T shifted {realCoord - T {0.25}};
+        const T q {shifted * shifted + imagSquare};
+        if (!(q * (q + shifted) > T {0.25} * imagSquare)) {
+            return true;
+        }
+        const T bulb {realCoord + T {1.0}};
+        return !(bulb * bulb + imagSquare > T {0.0625});
+    }
+
+    /**
+     * Iterate a single pixel in any arithmetic type, the vector kernels follow the same operation order.
+     * The orbit, the start iteration and the norm work as for escape_time.
+     *
+     * @return The escape iteration, maxIterations for bounded points.
+     */
+    template<typename T>
+    static int iterate(T realCoord, T imagCoord, int maxIterations, unsigned flags = None,
+                       Orbit<T>* orbit = nullptr, int startIteration = 0, T* norm = nullptr) {
+        const bool resume {orbit != nullptr && startIteration > 0};
+        const int bounded {orbit != nullptr ? Settled : maxIterations};
+        if (norm != nullptr) {
+            *norm = T {};
+        }
+
+        // A resumed pixel already passed the interior test in the run that stopped it
+        if (!resume && (flags & SkipInterior) && is_interior(realCoord, imagCoord)) {
+            return bounded;
+        }
+
+        // Initialize the real and imaginary parts of the complex number to 0
+        T realComponent {}, imagComponent {};
+        int iters {};
+
+        // Orbit point saved for cycle detection
+        using std::abs;
+        const bool detectPeriod {(flags & DetectPeriod) != 0};
+        const T tolerance {period_tolerance<T>()};
+        T savedReal {}, savedImag {};
+        int checkpoint {FirstCheckpoint};
+
+        if (resume) {
+            realComponent = orbit->re;
+            imagComponent = orbit->im;
+            savedReal = orbit->savedRe;
+            savedImag = orbit->savedIm;
+            checkpoint = resume_checkpoint(startIteration, maxIterations);
+        }
+
+        for (iters = resume ? startIteration : 0; iters < maxIterations; ++iters) {
+
+            // Calculate the next point in the sequence
+            T tr {realComponent * realComponent - imagComponent * imagComponent + realCoord};
+            imagComponent = (realComponent + realComponent) * imagComponent + imagCoord;
+            realComponent = tr;
+
+            // If the point is outside the circle of radius 2, exit the loop early
+            const T magnitude {realComponent * realComponent + imagComponent * imagComponent};
+            if (magnitude > T {4.0}) {
+                if (norm != nullptr) {
+                    *norm = magnitude;
+                }
+                break;
+            }
+
+            // An orbit that came back to a saved point repeats forever
+            if (detectPeriod) {
+                if (abs(realComponent - savedReal) + abs(imagComponent - savedImag) < tolerance) {
+                    return bounded;
+                }
+                if (iters == checkpoint) {
+                    savedReal = realComponent;
+                    savedImag = imagComponent;
+                    checkpoint = next_checkpoint(checkpoint, maxIterations);
+                }
+            }
+        }
+
+        if (orbit != nullptr && iters == maxIterations) {
+            *orbit = {realComponent, imagComponent, savedReal, savedImag};
+        }
+        return iters;
+    }
+};
+
+#endif //SFML_PROJECT_SIMDKERNEL_H
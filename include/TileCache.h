@@ -0,0 +1,88 @@
+#ifndef SFML_PROJECT_TILECACHE_H
+#define SFML_PROJECT_TILECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Results of square blocks of pixels, kept across frames so views that come back render from memory.
+// Pixels are addressed like a slippy map, on a lattice the engine numbers: pixel (px, py) of a lattice is
+// one point of the plane, whichever view it was rendered for. Tile (tx, ty) of a lattice holds the pixels
+// tx * Size to tx * Size + Size - 1 and ty * Size to ty * Size + Size - 1. A tile is only valid for the
+// iteration limit and the formula it was computed with, both are part of its key. Once the cache is full,
+// the tile used longest ago makes room for the new one.
+class TileCache {
+public:
+    struct Key {
+        std::uint64_t lattice;
+        std::int64_t tx;
+        std::int64_t ty;
+        int maxIterations;
+
+        // the iteration and every setting that changes its results, z^2 + c is the only formula so far
+        std::uint32_t formula;
+
+        friend bool operator==(const Key& a, const Key& b) {
+            return a.lattice == b.lattice && a.tx == b.tx && a.ty == b.ty && a.maxIterations == b.maxIterations &&
+                   a.formula == b.formula;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    // escape counts row by row, -1 for pixels no frame got to yet, and the smooth fractions if kept
+    struct Tile {
+        std::vector<int> iterations {};
+        std::vector<float> fractions {};
+    };
+
+    static constexpr int Size {64};
+
+    // a tile takes 16 KiB, 32 KiB with fractions, so the default holds up to 128 MiB
+    static constexpr std::size_t DefaultCapacity {4096};
+
+private:
+    using Entry = std::pair<Key, Tile>;
+
+    // most recently used first
+    std::list<Entry> m_tiles {};
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index {};
+    std::size_t m_capacity {};
+
+public:
+    explicit TileCache(std::size_t capacity = DefaultCapacity);
+
+    // public functions
+
+    /**
+     * Look a tile up and mark it as just used.
+     *
+     * @return The tile, null if it is not in the cache.
+     */
+    Tile* find(const Key& key);
+
+    /**
+     * Get the tile for the key, a new one starts with every pixel missing. It is marked as just used,
+     * the tile used longest ago is dropped if the cache is full.
+     *
+     * @param smooth Whether a new tile keeps smooth fractions.
+     */
+    Tile& insert(const Key& key, bool smooth);
+
+    void clear();
+
+    // setters
+    void set_capacity(std::size_t capacity);
+
+    // getters
+    [[nodiscard]] std::size_t get_size() const;
+
+    [[nodiscard]] std::size_t get_capacity() const;
+};
+
+#endif //SFML_PROJECT_TILECACHE_H
@@ -0,0 +1,78 @@
+#ifndef SFML_PROJECT_TILESCHEDULER_H
+#define SFML_PROJECT_TILESCHEDULER_H
+
+#include "CancellationToken.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of render threads that splits a frame into small rectangular tiles.
+// Every thread owns a deque of tiles, works through it from the back and steals from the front of the
+// others once it runs dry, so tiles on the set boundary that take far longer than the exterior ones
+// never leave cores idle at the end of a frame.
+class TileScheduler {
+public:
+    struct Tile {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    using Work = std::function<void(const Tile&)>;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Tile> tiles;
+    };
+
+    // queue 0 belongs to the thread calling run, the others to the pool threads
+    std::vector<std::unique_ptr<Queue>> m_queues {};
+    std::vector<std::thread> m_threads {};
+
+    std::mutex m_mutex {};
+    std::condition_variable m_wake {};
+    std::condition_variable m_done {};
+
+    // current frame, the generation tells pool threads a new one started
+    const Work* m_work {};
+    const CancellationToken* m_cancel {};
+    unsigned m_generation {};
+    int m_busy {};
+    bool m_stop {};
+
+    // private functions
+    void worker_loop(int index);
+
+    void drain(int index);
+
+    bool pop(int index, Tile& tile);
+
+    bool steal(int index, Tile& tile);
+
+public:
+    // 0 threads uses every hardware thread
+    explicit TileScheduler(int threads = 0);
+
+    ~TileScheduler();
+
+    TileScheduler(const TileScheduler&) = delete;
+
+    TileScheduler& operator=(const TileScheduler&) = delete;
+
+    // public functions
+    void run(sf::Vector2i screen, int tileSize, const Work& work, const CancellationToken& cancel = {});
+
+    // getters
+    [[nodiscard]] int get_thread_count() const;
+};
+
+#endif //SFML_PROJECT_TILESCHEDULER_H
@@ -6,6 +6,7 @@
 #define SFML_PROJECT_WINDOW_H
 
 #include "Mandelbrot.h"
+#include "Renderer.h"
 
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
@@ -19,8 +20,9 @@ private:
     sf::Vector2i m_screen {};
     sf::Event m_event {};
 
-    // mandelbrot
-    sf::Image m_image {};
+    // mandelbrot, the last frame fetched from the renderer
+    Renderer::Frame m_frame {};
+    unsigned m_frameGeneration {};
     sf::Texture m_texture {};
     sf::Sprite m_sprite {};
 
@@ -35,7 +37,6 @@ private:
     // private functions
     void init_variables();
     void init_window();
-    void init_image();
     void init_texture();
 
 public:
@@ -52,23 +53,24 @@ public:
 
     void set_text();
 
-    void update_text(Mandelbrot& mandelbrot);
-
-    void update_texture(Mandelbrot& mandelbrot);
+    void update_text(const Renderer& renderer);
 
     void update_sprite();
 
-    void poll_events(Mandelbrot& mandelbrot);
+    void poll_events(Renderer& renderer);
 
-    void update(Mandelbrot& mandelbrot);
+    void update(Renderer& renderer);
 
-    void render(Mandelbrot& mandelbrot);
+    void render(Renderer& renderer);
 
-    void handle_mouse_event(const sf::Event::MouseButtonEvent &mouseEvent, Mandelbrot &mandelbrot) const;
+    void handle_mouse_event(const sf::Event::MouseButtonEvent &mouseEvent, Renderer &renderer) const;
 
     static void adjust_max_iterations(Mandelbrot &mandelbrot, int delta, double scaleFactor);
 
-    static void handle_key_press_event(const sf::Event &event, Mandelbrot &mandelbrot);
+    static void handle_key_press_event(const sf::Event &event, Renderer &renderer);
+
+    // getters
+    [[nodiscard]] sf::Vector2i get_screen() const;
 };
 
 #endif //SFML_PROJECT_WINDOW_H
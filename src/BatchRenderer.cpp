@@ -0,0 +1,623 @@
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <utility>
+
+using Clock = std::chrono::steady_clock;
+using Seconds = std::chrono::duration<double>;
+
+BatchRenderer::BatchRenderer(Options options) : m_options {std::move(options)} {}
+
+bool BatchRenderer::parse_arguments(int argc, char** argv, Options& options, std::ostream& errors) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument {argv[i]};
+
+        // Options taking values check that enough arguments follow
+        auto values = [&](int count) {
+            if (i + count >= argc) {
+                errors << argument << " needs " << count << (count == 1 ? " value\n" : " values\n");
+                return false;
+            }
+            return true;
+        };
+
+        if (argument == "--center") {
+            if (!values(2)) {
+                return false;
+            }
+            options.centerRe = argv[++i];
+            options.centerIm = argv[++i];
+        } else if (argument == "--span") {
+            if (!values(1)) {
+                return false;
+            }
+            char* end {};
+            options.span = std::strtold(argv[++i], &end);
+            if (*end != '\0' || !(options.span > 0) || !std::isfinite(options.span)) {
+                errors << "--span must be a positive number, got " << argv[i] << "\n";
+                return false;
+            }
+        } else if (argument == "--iterations") {
+            if (!values(1)) {
+                return false;
+            }
+            char* end {};
+            const long iterations {std::strtol(argv[++i], &end, 10)};
+            if (*end != '\0' || iterations < 1 || iterations > 1000000000L) {
+                errors << "--iterations must be a whole number from 1 to 1000000000, got " << argv[i] << "\n";
+                return false;
+            }
+            options.maxIterations = static_cast<int>(iterations);
+        } else if (argument == "--size") {
+            if (!values(1)) {
+                return false;
+            }
+            char* end {};
+            const long width {std::strtol(argv[++i], &end, 10)};
+            const long height {*end == 'x' ? std::strtol(end + 1, &end, 10) : 0};
+            if (*end != '\0' || width < 1 || height < 1 || width > 1000000L || height > 1000000L) {
+                errors << "--size must look like 1920x1080, got " << argv[i] << "\n";
+                return false;
+            }
+            options.size = {static_cast<int>(width), static_cast<int>(height)};
+        } else if (argument == "--output") {
+            if (!values(1)) {
+                return false;
+            }
+            options.output = argv[++i];
+        } else if (argument == "--band-rows") {
+            if (!values(1)) {
+                return false;
+            }
+            char* end {};
+            const long rows {std::strtol(argv[++i], &end, 10)};
+            if (*end != '\0' || rows < 1 || rows > 1000000L) {
+                errors << "--band-rows must be a whole number from 1 to 1000000, got " << argv[i] << "\n";
+                return false;
+            }
+            options.bandRows = static_cast<int>(rows);
+        } else if (argument == "--checkpoint") {
+            if (!values(1)) {
+                return false;
+            }
+            char* end {};
+            options.checkpointSeconds = std::strtod(argv[++i], &end);
+            if (*end != '\0' || !(options.checkpointSeconds >= 0) || !std::isfinite(options.checkpointSeconds)) {
+                errors << "--checkpoint must be a number of seconds, got " << argv[i] << "\n";
+                return false;
+            }
+        } else if (argument == "--data") {
+            if (!values(1)) {
+                return false;
+            }
+            options.data = argv[++i];
+        } else if (argument == "--recolor") {
+            if (!values(1)) {
+                return false;
+            }
+            options.recolor = argv[++i];
+        } else if (argument == "--palette-offset") {
+            if (!values(1)) {
+                return false;
+            }
+            char* end {};
+            options.paletteOffset = std::strtod(argv[++i], &end);
+            if (*end != '\0' || !std::isfinite(options.paletteOffset)) {
+                errors << "--palette-offset must be a number, got " << argv[i] << "\n";
+                return false;
+            }
+        } else if (argument == "--resume") {
+            options.resume = true;
+        } else if (argument == "--smooth") {
+            options.smoothColoring = true;
+        } else {
+            errors << "unknown option " << argument << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+void BatchRenderer::print_usage(const char* program, std::ostream& out) {
+    out << "Usage: " << program << " [options]\n"
+        << "Without options the interactive window opens, with any of them one view is rendered to a file.\n"
+        << "  --center <re> <im>   view center, any number of digits (default -0.75 0)\n"
+        << "  --span <width>       width of the view on the complex plane (default 3.5)\n"
+        << "  --iterations <n>     iteration limit (default 1024)\n"
+        << "  --size <w>x<h>       image size in pixels (default 1920x1080)\n"
+        << "  --output <file>      image file, the extension picks the format (default mandelbrot.png)\n"
+        << "                       a PNG is written band by band and can be any size, other formats are\n"
+        << "                       rendered as one frame in memory\n"
+        << "  --band-rows <n>      rows rendered at a time for a PNG (default about 4 million pixels)\n"
+        << "  --checkpoint <s>     seconds between checkpoints of a PNG render (default 60)\n"
+        << "  --resume             continue the PNG render recorded in <file>.checkpoint, the view and\n"
+        << "                       iterations come from the checkpoint, so does the iteration file it was\n"
+        << "                       writing unless --data names where that file is now\n"
+        << "  --data <file>        also store the escape counts in an iteration file\n"
+        << "  --recolor <file>     color the iteration file instead of rendering, the view comes from it\n"
+        << "  --smooth             color by the smooth escape count\n"
+        << "  --palette-offset <f> rotate the palette by a fraction of its length (default 0)\n";
+}
+
+/**
+ * Read the view center. It gets enough limbs for every digit given, the engine raises that further if the
+ * pixel spacing needs more.
+ */
+bool BatchRenderer::read_center(std::ostream& errors) {
+    const auto digits {std::max(m_options.centerRe.size(), m_options.centerIm.size())};
+    const int precision {std::max(BigFloat::precision_for(m_options.span / m_options.size.x),
+                                  static_cast<int>(digits * std::log2(10.0) / 32) + 2)};
+
+    if (!BigFloat::parse(m_options.centerRe, precision, m_centerRe)) {
+        errors << "the real part of the center is not a number: " << m_options.centerRe << "\n";
+        return false;
+    }
+    if (!BigFloat::parse(m_options.centerIm, precision, m_centerIm)) {
+        errors << "the imaginary part of the center is not a number: " << m_options.centerIm << "\n";
+        return false;
+    }
+
+    // Bands are never revisited, keeping their tiles would only take memory
+    m_mandelbrot.set_tile_cache(false);
+    m_mandelbrot.set_max_iterations(m_options.maxIterations);
+    m_mandelbrot.set_smooth_coloring(m_options.smoothColoring);
+    m_mandelbrot.set_palette_offset(m_options.paletteOffset);
+    return true;
+}
+
+bool BatchRenderer::writes_png() const {
+    std::string extension {std::filesystem::path {m_options.output}.extension().string()};
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".png";
+}
+
+int BatchRenderer::band_rows() const {
+    const sf::Vector2i size {m_options.size};
+    return m_options.bandRows > 0 ? std::min(m_options.bandRows, size.y)
+                                  : static_cast<int>(std::clamp(BandPixels / size.x, 1L, static_cast<long>(size.y)));
+}
+
+/**
+ * Point the engine at a band of rows of the image. The engine keeps the view of the whole image and only
+ * renders the band's rows of it, so every pixel is computed from the image origin exactly as in one big
+ * frame, whatever the band height.
+ *
+ * @param top First row of the band.
+ */
+void BatchRenderer::set_band(int top) {
+    const long double spacing {m_options.span / m_options.size.x};
+    m_mandelbrot.set_span(m_options.span, spacing * m_options.size.y);
+    m_mandelbrot.set_center(m_centerRe, m_centerIm);
+    m_mandelbrot.set_band(top, m_options.size.y);
+}
+
+/**
+ * Open the iteration file the options name, if any. A render from the top creates it, a resumed render
+ * continues the file it wrote before, which has to hold the same view and every row up to the first one
+ * still to render.
+ *
+ * @param firstRow First row the render will store.
+ */
+bool BatchRenderer::open_data(std::ostream& errors, int firstRow) {
+    if (m_options.data.empty()) {
+        return true;
+    }
+    const IterationFile::View view {m_centerRe, m_centerIm, m_options.span, m_options.maxIterations,
+                                    m_options.size};
+    const std::uint32_t channels {IterationFile::Iterations | (m_options.smoothColoring ? IterationFile::Smooth : 0u)};
+    if (firstRow == 0) {
+        if (!m_data.create(m_options.data, view, channels)) {
+            errors << "could not write " << m_options.data << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    const IterationFile::View& stored {m_data.get_view()};
+    if (!m_data.open(m_options.data, true) || stored.centerRe != view.centerRe || stored.centerIm != view.centerIm ||
+        stored.span != view.span || stored.maxIterations != view.maxIterations || stored.size != view.size ||
+        m_data.has_channel(IterationFile::Smooth) != m_options.smoothColoring ||
+        m_data.get_rows_written() < firstRow) {
+        m_data.close();
+        errors << "could not continue " << m_options.data << ", it does not match the checkpoint\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Copy the engine's results for the band it just rendered into the iteration file, if one is open.
+ */
+void BatchRenderer::store_band(int top, int rows) {
+    if (!m_data.is_open()) {
+        return;
+    }
+    const std::vector<float>& fractions {m_mandelbrot.get_fractions()};
+    m_data.write_rows(top, rows, m_mandelbrot.get_iterations().data(), fractions.empty() ? nullptr : fractions.data());
+}
+
+int BatchRenderer::run(std::ostream& out, std::ostream& errors) {
+    if (!m_options.recolor.empty()) {
+        if (m_options.resume) {
+            errors << "a recolor cannot be resumed, it starts over quickly\n";
+            return EXIT_FAILURE;
+        }
+        return recolor(out, errors);
+    }
+
+    Checkpoint checkpoint {};
+    if (m_options.resume) {
+        if (!load_checkpoint(checkpoint_path(), checkpoint)) {
+            errors << "there is no checkpoint to resume from at " << checkpoint_path() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        // The view and the iteration file being written come from the checkpoint, where to write the image
+        // and how often to checkpoint from the command line; --data only points at a file that was moved
+        checkpoint.options.output = m_options.output;
+        checkpoint.options.checkpointSeconds = m_options.checkpointSeconds;
+        if (!m_options.data.empty()) {
+            checkpoint.options.data = m_options.data;
+        }
+        checkpoint.options.resume = true;
+        m_options = checkpoint.options;
+    }
+
+    if (!read_center(errors)) {
+        return EXIT_FAILURE;
+    }
+
+    if (writes_png()) {
+        return render_bands(out, errors, m_options.resume ? &checkpoint : nullptr);
+    }
+    if (m_options.resume) {
+        errors << "only PNG renders can be resumed\n";
+        return EXIT_FAILURE;
+    }
+    return render_frame(out, errors);
+}
+
+int BatchRenderer::render_frame(std::ostream& out, std::ostream& errors) {
+    if (!open_data(errors, 0)) {
+        return EXIT_FAILURE;
+    }
+    set_band(0);
+
+    const auto renderStart {Clock::now()};
+    m_mandelbrot.mandy(m_options.size);
+    const Seconds renderTime {Clock::now() - renderStart};
+    report(out, renderTime.count(), m_mandelbrot.get_iteration_count());
+
+    store_band(0, m_options.size.y);
+    if (m_data.is_open() && !m_data.flush()) {
+        errors << "could not write " << m_options.data << "\n";
+        return EXIT_FAILURE;
+    }
+    return write_image(m_mandelbrot.get_framebuffer(), out, errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Encode a whole frame in the format the output extension names.
+ */
+bool BatchRenderer::write_image(const Framebuffer& framebuffer, std::ostream& out, std::ostream& errors) const {
+    const auto encodeStart {Clock::now()};
+    sf::Image image {};
+    image.create(framebuffer.get_size().x, framebuffer.get_size().y, framebuffer.data());
+    if (!image.saveToFile(m_options.output)) {
+        errors << "could not write " << m_options.output << "\n";
+        return false;
+    }
+    const Seconds encodeTime {Clock::now() - encodeStart};
+    out << std::setprecision(3) << "Wrote " << m_options.output << " in " << encodeTime.count() << " s\n";
+    return true;
+}
+
+/**
+ * Render the image band by band into a streaming PNG. A band is encoded on a thread of its own while the
+ * next one renders, so the cores stay busy through the encode. Besides the engine's own band only the
+ * copy being encoded is held in memory.
+ *
+ * Once a band is encoded and the checkpoint interval has passed, the file state is written to the
+ * checkpoint. The checkpoint is removed when the image is complete.
+ *
+ * @param resumeFrom Checkpoint of an earlier run of the same render to continue, null to start anew.
+ */
+int BatchRenderer::render_bands(std::ostream& out, std::ostream& errors, const Checkpoint* resumeFrom) {
+    const sf::Vector2i size {m_options.size};
+    const int bandRows {band_rows()};
+
+    // Totals of the bands rendered so far, and of those already encoded, which a checkpoint may record
+    Checkpoint progress {m_options, {}, 0, 0.0};
+    double renderSeconds {};
+    std::uint64_t iterations {};
+    int firstRow {};
+
+    PngWriter writer {};
+    std::error_code error {};
+    if (resumeFrom != nullptr) {
+        if (!writer.resume(m_options.output, size, resumeFrom->state)) {
+            errors << "could not continue " << m_options.output << ", it does not match its checkpoint\n";
+            return EXIT_FAILURE;
+        }
+        firstRow = resumeFrom->state.rows;
+        renderSeconds = resumeFrom->renderSeconds;
+        iterations = resumeFrom->iterations;
+        out << "Resuming at row " << firstRow << " of " << size.y << "\n";
+    } else {
+        // A checkpoint left over from an earlier render would not match the new file
+        std::filesystem::remove(checkpoint_path(), error);
+        if (!writer.open(m_options.output, size)) {
+            errors << "could not write " << m_options.output << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    if (!open_data(errors, firstRow)) {
+        return EXIT_FAILURE;
+    }
+
+    const auto start {Clock::now()};
+    auto lastCheckpoint {start};
+    int reportedPercent {firstRow * 100 / size.y};
+
+    Framebuffer band {};
+    std::future<bool> encoding {};
+    for (int top = firstRow; top < size.y; top += bandRows) {
+        const int rows {std::min(bandRows, size.y - top)};
+        set_band(top);
+
+        const auto renderStart {Clock::now()};
+        m_mandelbrot.mandy({size.x, rows});
+        renderSeconds += Seconds {Clock::now() - renderStart}.count();
+        iterations += m_mandelbrot.get_iteration_count();
+        store_band(top, rows);
+
+        // The copy waits for the previous band to be encoded, it shares the buffer
+        if (encoding.valid()) {
+            if (!encoding.get()) {
+                errors << "could not write " << m_options.output << "\n";
+                return EXIT_FAILURE;
+            }
+            if (Seconds {Clock::now() - lastCheckpoint}.count() >= m_options.checkpointSeconds) {
+                // The iteration file holds the rows the checkpoint covers before the checkpoint says so
+                progress.state = writer.get_state();
+                if ((m_data.is_open() && !m_data.flush()) || !save_checkpoint(checkpoint_path(), progress)) {
+                    errors << "could not write the checkpoint " << checkpoint_path() << "\n";
+                }
+                lastCheckpoint = Clock::now();
+            }
+        }
+        band.copy_from(m_mandelbrot.get_framebuffer());
+        encoding = std::async(std::launch::async, [&writer, &band] { return writer.write_rows(band); });
+        progress.iterations = iterations;
+        progress.renderSeconds = renderSeconds;
+
+        const int percent {static_cast<int>((top + rows) * 100L / size.y)};
+        if (percent / 10 > reportedPercent / 10 && top + rows < size.y) {
+            reportedPercent = percent;
+            out << percent << "% rendered\n" << std::flush;
+        }
+    }
+
+    if ((encoding.valid() && !encoding.get()) || !writer.close()) {
+        errors << "could not write " << m_options.output << "\n";
+        return EXIT_FAILURE;
+    }
+    if (m_data.is_open() && !m_data.flush()) {
+        errors << "could not write " << m_options.data << "\n";
+        return EXIT_FAILURE;
+    }
+    std::filesystem::remove(checkpoint_path(), error);
+
+    // The render time is what the bands took, the total includes the encode of the last band
+    report(out, renderSeconds, iterations);
+    const Seconds wallTime {Clock::now() - start};
+    out << std::setprecision(3) << "Wrote " << m_options.output << " in bands of " << bandRows << " rows, "
+        << wallTime.count() << " s in total\n";
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Color the escape counts of an iteration file into the output image without rendering anything. The
+ * counts are read straight from the mapped file, a PNG goes out in bands like a render, so only the
+ * pages of the band being colored need to be in memory.
+ * The view and the iteration limit are the file's, the coloring options are taken from the command line.
+ */
+int BatchRenderer::recolor(std::ostream& out, std::ostream& errors) {
+    IterationFile data {};
+    if (!data.open(m_options.recolor)) {
+        errors << m_options.recolor << " is not an iteration file this version can read\n";
+        return EXIT_FAILURE;
+    }
+    const IterationFile::View& view {data.get_view()};
+    if (!data.has_channel(IterationFile::Iterations) || data.get_rows_written() < view.size.y) {
+        errors << "the render stored in " << m_options.recolor << " did not finish\n";
+        return EXIT_FAILURE;
+    }
+    const bool smooth {m_options.smoothColoring && data.has_channel(IterationFile::Smooth)};
+    if (m_options.smoothColoring && !smooth) {
+        out << m_options.recolor << " holds no smooth fractions, coloring by whole escape counts\n";
+    }
+    m_options.size = view.size;
+    m_options.maxIterations = view.maxIterations;
+
+    Palette palette {};
+    palette.build(view.maxIterations);
+    palette.set_offset(m_options.paletteOffset);
+
+    // Color the rows of the image from top into the band, all of its rows at once
+    const std::int32_t* counts {data.get_iterations()};
+    const float* fractions {data.get_fractions()};
+    auto color = [&](int top, Framebuffer& band) {
+        const sf::Vector2i bandSize {band.get_size()};
+
+#pragma omp parallel for default(none) shared(top, band, bandSize, counts, fractions, smooth, palette)
+        for (int y = 0; y < bandSize.y; ++y) {
+            const size_t row {static_cast<size_t>(top + y) * bandSize.x};
+            for (int x = 0; x < bandSize.x; ++x) {
+                const int iters {counts[row + x]};
+                band.set_pixel(x, y, smooth ? palette.color(iters, fractions[row + x]) : palette.color(iters));
+            }
+        }
+    };
+
+    const auto start {Clock::now()};
+    Framebuffer band {};
+    if (!writes_png()) {
+        band.resize(view.size);
+        color(0, band);
+        if (!write_image(band, out, errors)) {
+            return EXIT_FAILURE;
+        }
+    } else {
+        // A checkpoint left over from a render to the same file would not match the new file
+        std::error_code error {};
+        std::filesystem::remove(checkpoint_path(), error);
+        PngWriter writer {};
+        if (!writer.open(m_options.output, view.size)) {
+            errors << "could not write " << m_options.output << "\n";
+            return EXIT_FAILURE;
+        }
+        const int bandRows {band_rows()};
+        for (int top = 0; top < view.size.y; top += bandRows) {
+            band.resize({view.size.x, std::min(bandRows, view.size.y - top)});
+            color(top, band);
+            if (!writer.write_rows(band)) {
+                errors << "could not write " << m_options.output << "\n";
+                return EXIT_FAILURE;
+            }
+        }
+        if (!writer.close()) {
+            errors << "could not write " << m_options.output << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    const Seconds wallTime {Clock::now() - start};
+    out << std::setprecision(3) << "Recolored " << view.size.x << "x" << view.size.y << " at "
+        << view.maxIterations << " iterations from " << m_options.recolor << " into " << m_options.output
+        << " in " << wallTime.count() << " s\n";
+    return EXIT_SUCCESS;
+}
+
+std::string BatchRenderer::checkpoint_path() const {
+    return m_options.output + ".checkpoint";
+}
+
+/**
+ * Write the checkpoint as text, with the last row of the file in binary at the end. It goes to a temporary
+ * file first and replaces the old checkpoint in one rename, so a kill midway leaves the old one intact.
+ */
+bool BatchRenderer::save_checkpoint(const std::string& path, const Checkpoint& checkpoint) {
+    const std::string temporary {path + ".tmp"};
+    {
+        std::ofstream file {temporary, std::ios::binary | std::ios::trunc};
+        const Options& options {checkpoint.options};
+        const PngWriter::State& state {checkpoint.state};
+        file << std::setprecision(std::numeric_limits<long double>::max_digits10);
+        file << CheckpointHeader << " " << CheckpointVersion << "\n"
+             << "centerRe " << options.centerRe << "\n"
+             << "centerIm " << options.centerIm << "\n"
+             << "span " << options.span << "\n"
+             << "maxIterations " << options.maxIterations << "\n"
+             << "size " << options.size.x << " " << options.size.y << "\n"
+             << "smoothColoring " << options.smoothColoring << "\n"
+             << "paletteOffset " << options.paletteOffset << "\n"
+             << "bandRows " << options.bandRows << "\n"
+             << "data " << std::quoted(options.data) << "\n"
+             << "rows " << state.rows << "\n"
+             << "bytes " << state.bytes << "\n"
+             << "adler " << state.adler << "\n"
+             << "iterations " << checkpoint.iterations << "\n"
+             << "renderSeconds " << checkpoint.renderSeconds << "\n"
+             << "previousRow " << state.previousRow.size() << "\n";
+        file.write(reinterpret_cast<const char*>(state.previousRow.data()),
+                   static_cast<std::streamsize>(state.previousRow.size()));
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::error_code error {};
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+bool BatchRenderer::load_checkpoint(const std::string& path, Checkpoint& checkpoint) {
+    std::ifstream file {path, std::ios::binary};
+    std::string header {};
+    int version {};
+    if (!(file >> header >> version) || header != CheckpointHeader || version != CheckpointVersion) {
+        return false;
+    }
+
+    Options& options {checkpoint.options};
+    PngWriter::State& state {checkpoint.state};
+    std::string key {};
+    while (file >> key) {
+        if (key == "centerRe") {
+            file >> options.centerRe;
+        } else if (key == "centerIm") {
+            file >> options.centerIm;
+        } else if (key == "span") {
+            file >> options.span;
+        } else if (key == "maxIterations") {
+            file >> options.maxIterations;
+        } else if (key == "size") {
+            file >> options.size.x >> options.size.y;
+        } else if (key == "smoothColoring") {
+            file >> options.smoothColoring;
+        } else if (key == "paletteOffset") {
+            file >> options.paletteOffset;
+        } else if (key == "bandRows") {
+            file >> options.bandRows;
+        } else if (key == "data") {
+            file >> std::quoted(options.data);
+        } else if (key == "rows") {
+            file >> state.rows;
+        } else if (key == "bytes") {
+            file >> state.bytes;
+        } else if (key == "adler") {
+            file >> state.adler;
+        } else if (key == "iterations") {
+            file >> checkpoint.iterations;
+        } else if (key == "renderSeconds") {
+            file >> checkpoint.renderSeconds;
+        } else if (key == "previousRow") {
+            // The binary row is the last entry and starts right after the end of this line
+            std::size_t size {};
+            file >> size;
+            file.get();
+            state.previousRow.resize(size);
+            file.read(reinterpret_cast<char*>(state.previousRow.data()), static_cast<std::streamsize>(size));
+            return static_cast<bool>(file) && options.size.x > 0 && options.size.y > 0;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * Print the render time and throughput. The iterations are the escape-time iterations the image stands
+ * for, the same measure whatever the engine skipped.
+ */
+void BatchRenderer::report(std::ostream& out, double renderSeconds, std::uint64_t iterations) const {
+    const double pixels {static_cast<double>(m_options.size.x) * m_options.size.y};
+    out << "Rendered " << m_options.size.x << "x" << m_options.size.y << " at " << m_options.maxIterations
+        << " iterations with " << m_mandelbrot.get_precision_name() << "\n";
+    out << std::fixed << std::setprecision(3) << "Render time: " << renderSeconds << " s, "
+        << std::setprecision(1) << pixels / renderSeconds / 1e6 << " M pixels/s, "
+        << iterations / renderSeconds / 1e6 << " M iterations/s (" << iterations << " iterations)\n";
+}
@@ -0,0 +1,336 @@
+#include "BigFloat.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+
+BigFloat::BigFloat(long double value, int precision) : BigFloat {value, 0, precision} {}
+
+BigFloat::BigFloat(long double value, int valueExponent, int precision) : m_limbs(precision + 1, 0) {
+    if (value == 0) {
+        return;
+    }
+    m_negative = value < 0;
+
+    // Split the value into a 64-bit integer mantissa and a binary exponent: value = bits * 2^(exponent - 64)
+    int exponent {};
+    const long double mantissa {std::frexp(std::fabs(value), &exponent)};
+    exponent += valueExponent;
+    const auto bits {static_cast<std::uint64_t>(std::ldexp(mantissa, 64))};
+
+    // Copy every set mantissa bit into the limb that holds its weight, bits below the precision are dropped
+    for (int bit = 0; bit < 64; ++bit) {
+        if (((bits >> bit) & 1) == 0) {
+            continue;
+        }
+        const int weight {exponent - 64 + bit};
+        if (weight >= 0) {
+            assert(weight < 32 && "BigFloat integer part overflow");
+            m_limbs[0] |= std::uint32_t {1} << weight;
+        } else {
+            const int fractionBit {-weight - 1};
+            const int limb {1 + fractionBit / 32};
+            if (limb <= precision) {
+                m_limbs[limb] |= std::uint32_t {1} << (31 - fractionBit % 32);
+            }
+        }
+    }
+}
+
+BigFloat::BigFloat(std::vector<std::uint32_t> limbs, bool negative) : m_limbs {std::move(limbs)},
+                                                                      m_negative {negative} {
+    if (m_limbs.empty()) {
+        m_limbs.push_back(0);
+    }
+    normalize_sign();
+}
+
+int BigFloat::precision_for(long double spacing) {
+    return precision_for(FloatExp<long double> {spacing});
+}
+
+int BigFloat::precision_for(const FloatExp<long double>& spacing) {
+    if (!(spacing.mantissa > 0)) {
+        return 2;
+    }
+
+    // The leading bit of the spacing has weight 2^(exponent - 1)
+    const int bits {-(spacing.exponent - 1) + 64};
+    return std::max(2, (bits + 31) / 32);
+}
+
+bool BigFloat::parse(const std::string& text, int precision, BigFloat& result) {
+    size_t position {};
+    const bool negative {position < text.size() && text[position] == '-'};
+    if (position < text.size() && (text[position] == '-' || text[position] == '+')) {
+        ++position;
+    }
+
+    // Collect the digits and remember how many of them come before the decimal point
+    std::string digits {};
+    long point {-1};
+    for (; position < text.size(); ++position) {
+        const char c {text[position]};
+        if (c >= '0' && c <= '9') {
+            digits += c;
+        } else if (c == '.' && point < 0) {
+            point = static_cast<long>(digits.size());
+        } else {
+            break;
+        }
+    }
+    if (digits.empty()) {
+        return false;
+    }
+    if (point < 0) {
+        point = static_cast<long>(digits.size());
+    }
+
+    // A decimal exponent only moves the point
+    if (position < text.size() && (text[position] == 'e' || text[position] == 'E')) {
+        char* end {};
+        const long exponent {std::strtol(text.c_str() + position + 1, &end, 10)};
+        if (end == text.c_str() + position + 1 || std::labs(exponent) > 100000) {
+            return false;
+        }
+        position = static_cast<size_t>(end - text.c_str());
+        point += exponent;
+    }
+    if (position != text.size()) {
+        return false;
+    }
+
+    std::uint64_t integer {};
+    for (long i = 0; i < point; ++i) {
+        integer = integer * 10 + (i < static_cast<long>(digits.size()) ? digits[i] - '0' : 0);
+        if (integer > std::numeric_limits<std::uint32_t>::max()) {
+            return false;
+        }
+    }
+
+    // Horner's scheme from the last fraction digit on: every step puts a digit in front of the fraction and
+    // divides by ten, the digits before the first one given are zeros
+    BigFloat value {};
+    value.m_limbs.assign(precision + 1, 0);
+    const long first {std::max(point, 0L)};
+    const long leadingZeros {std::max(-point, 0L)};
+    const long fractionDigits {leadingZeros + static_cast<long>(digits.size()) - first};
+    for (long i = fractionDigits - 1; i >= 0; --i) {
+        value.m_limbs[0] = i >= leadingZeros ? static_cast<std::uint32_t>(digits[first + i - leadingZeros] - '0') : 0;
+        std::uint64_t remainder {};
+        for (auto& limb : value.m_limbs) {
+            const std::uint64_t current {remainder << 32 | limb};
+            limb = static_cast<std::uint32_t>(current / 10);
+            remainder = current % 10;
+        }
+    }
+
+    value.m_limbs[0] = static_cast<std::uint32_t>(integer);
+    value.m_negative = negative;
+    value.normalize_sign();
+    result = std::move(value);
+    return true;
+}
+
+int BigFloat::get_precision() const {
+    return static_cast<int>(m_limbs.size()) - 1;
+}
+
+void BigFloat::set_precision(int precision) {
+    m_limbs.resize(precision + 1, 0);
+    normalize_sign();
+}
+
+bool BigFloat::is_negative() const {
+    return m_negative;
+}
+
+const std::vector<std::uint32_t>& BigFloat::get_limbs() const {
+    return m_limbs;
+}
+
+BigFloat::operator long double() const {
+
+    // Four limbs after the first non-zero one give more bits than a long double mantissa holds
+    long double result {0};
+    int significantLimbs {};
+    for (size_t i = 0; i < m_limbs.size() && significantLimbs < 4; ++i) {
+        result += std::ldexp(static_cast<long double>(m_limbs[i]), -32 * static_cast<int>(i));
+        if (result != 0) {
+            ++significantLimbs;
+        }
+    }
+    return m_negative ? -result : result;
+}
+
+BigFloat::operator FloatExp<long double>() const {
+
+    // Same four limbs as the long double conversion, counted from the first non-zero limb so nothing underflows
+    size_t first {};
+    while (first < m_limbs.size() && m_limbs[first] == 0) {
+        ++first;
+    }
+
+    long double mantissa {0};
+    for (size_t i = first; i < m_limbs.size() && i < first + 4; ++i) {
+        mantissa += std::ldexp(static_cast<long double>(m_limbs[i]), -32 * static_cast<int>(i - first));
+    }
+    return {m_negative ? -mantissa : mantissa, -32 * static_cast<int>(first)};
+}
+
+BigFloat::operator double() const {
+    return static_cast<double>(static_cast<long double>(*this));
+}
+
+BigFloat::operator float() const {
+    return static_cast<float>(static_cast<long double>(*this));
+}
+
+BigFloat::operator DoubleDouble() const {
+    const double high {static_cast<double>(*this)};
+    const double low {static_cast<double>(*this - BigFloat {high, get_precision()})};
+    return DoubleDouble::quick_two_sum(high, low);
+}
+
+int BigFloat::compare_magnitude(const BigFloat& a, const BigFloat& b) {
+    const size_t size {std::max(a.m_limbs.size(), b.m_limbs.size())};
+    for (size_t i = 0; i < size; ++i) {
+        const std::uint32_t limbA {i < a.m_limbs.size() ? a.m_limbs[i] : 0};
+        const std::uint32_t limbB {i < b.m_limbs.size() ? b.m_limbs[i] : 0};
+        if (limbA != limbB) {
+            return limbA < limbB ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+BigFloat BigFloat::add_magnitude(const BigFloat& a, const BigFloat& b) {
+    BigFloat result {};
+    result.m_limbs.assign(std::max(a.m_limbs.size(), b.m_limbs.size()), 0);
+
+    // Add from the least significant limb up, carrying into the next one
+    std::uint64_t carry {};
+    for (size_t i = result.m_limbs.size(); i-- > 0;) {
+        carry += i < a.m_limbs.size() ? a.m_limbs[i] : 0;
+        carry += i < b.m_limbs.size() ? b.m_limbs[i] : 0;
+        result.m_limbs[i] = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+    }
+    assert(carry == 0 && "BigFloat integer part overflow");
+    return result;
+}
+
+BigFloat BigFloat::subtract_magnitude(const BigFloat& larger, const BigFloat& smaller) {
+    BigFloat result {};
+    result.m_limbs.assign(std::max(larger.m_limbs.size(), smaller.m_limbs.size()), 0);
+
+    // Subtract from the least significant limb up, borrowing from the next one
+    std::int64_t borrow {};
+    for (size_t i = result.m_limbs.size(); i-- > 0;) {
+        std::int64_t difference {borrow};
+        difference += i < larger.m_limbs.size() ? larger.m_limbs[i] : 0;
+        difference -= i < smaller.m_limbs.size() ? smaller.m_limbs[i] : 0;
+        borrow = difference < 0 ? -1 : 0;
+        result.m_limbs[i] = static_cast<std::uint32_t>(difference + (difference < 0 ? std::int64_t {1} << 32 : 0));
+    }
+    return result;
+}
+
+void BigFloat::normalize_sign() {
+
+    // Zero is always positive so that equality and sign checks stay simple
+    if (std::all_of(m_limbs.begin(), m_limbs.end(), [](std::uint32_t limb) { return limb == 0; })) {
+        m_negative = false;
+    }
+}
+
+BigFloat operator-(const BigFloat& a) {
+    BigFloat result {a};
+    result.m_negative = !a.m_negative;
+    result.normalize_sign();
+    return result;
+}
+
+BigFloat operator+(const BigFloat& a, const BigFloat& b) {
+    BigFloat result {};
+    if (a.m_negative == b.m_negative) {
+        result = BigFloat::add_magnitude(a, b);
+        result.m_negative = a.m_negative;
+    } else if (BigFloat::compare_magnitude(a, b) >= 0) {
+        result = BigFloat::subtract_magnitude(a, b);
+        result.m_negative = a.m_negative;
+    } else {
+        result = BigFloat::subtract_magnitude(b, a);
+        result.m_negative = b.m_negative;
+    }
+    result.normalize_sign();
+    return result;
+}
+
+BigFloat operator-(const BigFloat& a, const BigFloat& b) {
+    return a + -b;
+}
+
+/**
+ * Multiply two numbers, truncating the product to the larger of the two precisions.
+ * Partial products are split into 32-bit halves and summed per column, carries are resolved once at the end.
+ */
+BigFloat operator*(const BigFloat& a, const BigFloat& b) {
+    const int precision {std::max(a.get_precision(), b.get_precision())};
+    const int sizeA {static_cast<int>(a.m_limbs.size())};
+    const int sizeB {static_cast<int>(b.m_limbs.size())};
+
+    // One guard column below the last kept limb catches most of the truncated carries
+    std::vector<std::uint64_t> columns(precision + 2, 0);
+
+    for (int i = 0; i < sizeA; ++i) {
+        const std::uint64_t limbA {a.m_limbs[i]};
+        if (limbA == 0) {
+            continue;
+        }
+        const int last {std::min(sizeB - 1, precision + 1 - i)};
+        for (int j = 0; j <= last; ++j) {
+            const std::uint64_t product {limbA * b.m_limbs[j]};
+            columns[i + j] += product & 0xFFFFFFFFu;
+            if (i + j > 0) {
+                columns[i + j - 1] += product >> 32;
+            } else {
+                assert((product >> 32) == 0 && "BigFloat integer part overflow");
+            }
+        }
+    }
+
+    for (int k = precision + 1; k > 0; --k) {
+        columns[k - 1] += columns[k] >> 32;
+        columns[k] &= 0xFFFFFFFFu;
+    }
+    assert((columns[0] >> 32) == 0 && "BigFloat integer part overflow");
+
+    BigFloat result {};
+    result.m_limbs.resize(precision + 1);
+    for (int k = 0; k <= precision; ++k) {
+        result.m_limbs[k] = static_cast<std::uint32_t>(columns[k]);
+    }
+    result.m_negative = a.m_negative != b.m_negative;
+    result.normalize_sign();
+    return result;
+}
+
+BigFloat& BigFloat::operator+=(const BigFloat& other) {
+    return *this = *this + other;
+}
+
+BigFloat& BigFloat::operator-=(const BigFloat& other) {
+    return *this = *this - other;
+}
+
+bool operator==(const BigFloat& a, const BigFloat& b) {
+    return a.m_negative == b.m_negative && BigFloat::compare_magnitude(a, b) == 0;
+}
+
+bool operator!=(const BigFloat& a, const BigFloat& b) {
+    return !(a == b);
+}
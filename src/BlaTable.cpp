@@ -0,0 +1,78 @@
+#include "BlaTable.h"
+
+#include <algorithm>
+
+/**
+ * Build every level of the table for a reference orbit.
+ *
+ * A single step at iteration m is dz' = 2 Z_m dz + dc, which drops dz^2 and is exact to rounding while
+ * |dz| < 2 Epsilon |Z_m|. Two neighbouring runs x then y merge into
+ *     A = A_y A_x,  B = A_y B_x + B_y,  radius = min(r_x, (r_y - |B_x| |dc|) / |A_x|)
+ * where the second bound keeps the offset after x inside the radius of y. Levels are built bottom up,
+ * each level in parallel.
+ *
+ * @param reference Reference orbit the offsets are measured from.
+ * @param radius Largest distance of a pixel from the reference point.
+ */
+void BlaTable::build(const ReferenceOrbit& reference, double radius) {
+    m_generation = reference.get_generation();
+    m_radius = radius;
+    m_maxValidRadius = 0;
+    m_levels.clear();
+
+    // Only runs that end at or before the last stored point can be used
+    const auto& orbit {reference.get_orbit()};
+    const int count {static_cast<int>(orbit.size()) - 1};
+    if (count < 2) {
+        return;
+    }
+
+    std::vector<Step> steps(count);
+
+#pragma omp parallel for default(none) shared(orbit, steps, count)
+    for (int m = 0; m < count; ++m) {
+        const Complex<double> twiceZ {2 * orbit[m].re, 2 * orbit[m].im};
+        steps[m] = {twiceZ, {1.0, 0.0}, Epsilon * twiceZ.magnitude(), 1};
+    }
+    m_levels.push_back(std::move(steps));
+
+    while (m_levels.back().size() >= 2) {
+        const auto& lower {m_levels.back()};
+        const int size {static_cast<int>(lower.size() / 2)};
+        std::vector<Step> merged(size);
+
+#pragma omp parallel for default(none) shared(lower, merged, size, radius)
+        for (int i = 0; i < size; ++i) {
+            const Step& x {lower[2 * i]};
+            const Step& y {lower[2 * i + 1]};
+
+            const double scale {x.a.magnitude()};
+            const double reach {scale > 0 ? (y.radius - x.b.magnitude() * radius) / scale : 0.0};
+
+            merged[i] = {y.a * x.a, y.a * x.b + y.b, std::min(x.radius, std::max(0.0, reach)), x.length + y.length};
+        }
+        m_levels.push_back(std::move(merged));
+    }
+
+    // Longer runs never have a larger radius than the pairs they start with
+    if (m_levels.size() >= 2) {
+        for (const Step& step : m_levels[1]) {
+            m_maxValidRadius = std::max(m_maxValidRadius, step.radius);
+        }
+    }
+}
+
+/**
+ * Tables stay valid for the same orbit as long as no pixel is further from the reference than before,
+ * which lets zooming into the same reference reuse them.
+ */
+bool BlaTable::is_built_for(const ReferenceOrbit& reference, double radius) const {
+    return !m_levels.empty() && m_generation == reference.get_generation() && radius <= m_radius;
+}
+
+void BlaTable::reset() {
+    m_levels.clear();
+    m_generation = 0;
+    m_radius = 0;
+    m_maxValidRadius = 0;
+}
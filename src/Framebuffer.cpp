@@ -0,0 +1,66 @@
+#include "Framebuffer.h"
+
+#include <cstring>
+#include <new>
+
+void Framebuffer::AlignedDelete::operator()(sf::Uint8* pixels) const {
+    ::operator delete[](pixels, std::align_val_t {Alignment});
+}
+
+Framebuffer::Framebuffer(sf::Vector2i size) {
+    resize(size);
+}
+
+/**
+ * Make room for a frame of the given size. Nothing is allocated when the size stays the same, the pixels
+ * then keep their colors, otherwise the new frame starts out black.
+ */
+void Framebuffer::resize(sf::Vector2i size) {
+    if (size == m_size && m_pixels) {
+        return;
+    }
+
+    m_size = size;
+    const std::size_t bytes {get_byte_size()};
+    m_pixels.reset(bytes == 0 ? nullptr
+                              : static_cast<sf::Uint8*>(::operator new[](bytes, std::align_val_t {Alignment})));
+    clear();
+}
+
+void Framebuffer::clear(sf::Color color) {
+    const sf::Uint8 rgba[4] {color.r, color.g, color.b, color.a};
+    const std::size_t bytes {get_byte_size()};
+    for (std::size_t i = 0; i < bytes; i += 4) {
+        std::memcpy(m_pixels.get() + i, rgba, 4);
+    }
+}
+
+/**
+ * Take over the size and pixels of another frame, reusing the own allocation when the sizes match.
+ */
+void Framebuffer::copy_from(const Framebuffer& other) {
+    resize(other.m_size);
+    if (m_pixels) {
+        std::memcpy(m_pixels.get(), other.m_pixels.get(), get_byte_size());
+    }
+}
+
+sf::Uint8* Framebuffer::data() {
+    return m_pixels.get();
+}
+
+const sf::Uint8* Framebuffer::data() const {
+    return m_pixels.get();
+}
+
+sf::Vector2i Framebuffer::get_size() const {
+    return m_size;
+}
+
+std::size_t Framebuffer::get_byte_size() const {
+    return static_cast<std::size_t>(m_size.x) * m_size.y * 4;
+}
+
+bool Framebuffer::empty() const {
+    return !m_pixels;
+}
@@ -0,0 +1,230 @@
+#include "IterationFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+    // the start of every file, in the byte order of the machine that wrote it
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t channels;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t maxIterations;
+
+        // limbs of each center coordinate, integer limb included, they follow the header real part first
+        std::uint32_t limbs;
+
+        // bit 0 is set for a negative real part, bit 1 for a negative imaginary part
+        std::uint32_t negative;
+
+        // span = (spanHigh + spanLow) * 2^spanExponent, the two doubles hold every bit of a long double
+        double spanHigh;
+        double spanLow;
+        std::int32_t spanExponent;
+
+        std::uint32_t rows;
+        std::uint64_t offsets[IterationFile::ChannelCount];
+    };
+
+    static_assert(sizeof(Header) == 80, "the header layout is part of the file format");
+    static_assert(sizeof(int) == 4 && sizeof(float) == 4, "channels hold 32-bit values");
+
+    constexpr char Magic[8] {'M', 'A', 'N', 'D', 'I', 'T', 'E', 'R'};
+
+    // reads back in another order if the file came from a machine of the other byte order
+    constexpr std::uint32_t ByteOrder {0x01020304};
+
+    std::uint64_t align(std::uint64_t offset) {
+        return (offset + IterationFile::ChannelAlignment - 1) / IterationFile::ChannelAlignment *
+               IterationFile::ChannelAlignment;
+    }
+
+    int index_of(IterationFile::Channel channel) {
+        return channel == IterationFile::Iterations ? 0 : 1;
+    }
+}
+
+/**
+ * Lay the file out and write its header. The channels are left at zero, the file is sparse until rows
+ * are written on systems that support it.
+ */
+bool IterationFile::create(const std::string& path, const View& view, std::uint32_t channels) {
+    close();
+    m_view = view;
+    m_channels = channels & (Iterations | Smooth);
+    m_rowsWritten = 0;
+
+    // Both coordinates are stored with the same number of limbs
+    const int precision {std::max(view.centerRe.get_precision(), view.centerIm.get_precision())};
+    m_view.centerRe.set_precision(precision);
+    m_view.centerIm.set_precision(precision);
+    const auto limbs {static_cast<std::uint64_t>(precision) + 1};
+
+    const std::uint64_t plane {static_cast<std::uint64_t>(view.size.x) * view.size.y * 4};
+    std::uint64_t end {sizeof(Header) + 2 * limbs * 4};
+    for (int i = 0; i < ChannelCount; ++i) {
+        m_offsets[i] = 0;
+        if ((m_channels & (1u << i)) != 0) {
+            m_offsets[i] = align(end);
+            end = m_offsets[i] + plane;
+        }
+    }
+    if (!m_file.create(path, end)) {
+        return false;
+    }
+
+    Header header {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byteOrder = ByteOrder;
+    header.channels = m_channels;
+    header.width = static_cast<std::uint32_t>(view.size.x);
+    header.height = static_cast<std::uint32_t>(view.size.y);
+    header.maxIterations = static_cast<std::uint32_t>(view.maxIterations);
+    header.limbs = static_cast<std::uint32_t>(limbs);
+    header.negative = (m_view.centerRe.is_negative() ? 1u : 0u) | (m_view.centerIm.is_negative() ? 2u : 0u);
+
+    int exponent {};
+    const long double mantissa {std::frexp(view.span, &exponent)};
+    header.spanHigh = static_cast<double>(mantissa);
+    header.spanLow = static_cast<double>(mantissa - header.spanHigh);
+    header.spanExponent = exponent;
+    std::copy(std::begin(m_offsets), std::end(m_offsets), std::begin(header.offsets));
+
+    std::uint8_t* data {m_file.data()};
+    std::memcpy(data, &header, sizeof(header));
+    std::memcpy(data + sizeof(header), m_view.centerRe.get_limbs().data(), limbs * 4);
+    std::memcpy(data + sizeof(header) + limbs * 4, m_view.centerIm.get_limbs().data(), limbs * 4);
+    return true;
+}
+
+bool IterationFile::open(const std::string& path, bool writable) {
+    close();
+    if (!m_file.open(path, writable) || !read_header()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read the view and the channel layout, checking that everything the header points at lies in the file.
+ */
+bool IterationFile::read_header() {
+    const std::uint64_t size {m_file.get_size()};
+    if (size < sizeof(Header)) {
+        return false;
+    }
+    Header header {};
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.byteOrder != ByteOrder ||
+        header.version != Version) {
+        return false;
+    }
+    if (header.width == 0 || header.height == 0 || header.width > 1000000 || header.height > 1000000 ||
+        header.maxIterations == 0 || header.maxIterations > 1000000000 || header.rows > header.height ||
+        header.limbs == 0 || sizeof(Header) + 2ull * header.limbs * 4 > size) {
+        return false;
+    }
+
+    m_channels = header.channels & (Iterations | Smooth);
+    const std::uint64_t plane {static_cast<std::uint64_t>(header.width) * header.height * 4};
+    for (int i = 0; i < ChannelCount; ++i) {
+        m_offsets[i] = (m_channels & (1u << i)) != 0 ? header.offsets[i] : 0;
+        if ((m_channels & (1u << i)) != 0 &&
+            (m_offsets[i] % ChannelAlignment != 0 || m_offsets[i] < sizeof(Header) || m_offsets[i] > size ||
+             size - m_offsets[i] < plane)) {
+            return false;
+        }
+    }
+
+    std::vector<std::uint32_t> re(header.limbs);
+    std::vector<std::uint32_t> im(header.limbs);
+    std::memcpy(re.data(), m_file.data() + sizeof(header), header.limbs * 4ull);
+    std::memcpy(im.data(), m_file.data() + sizeof(header) + header.limbs * 4ull, header.limbs * 4ull);
+    m_view.centerRe = BigFloat {std::move(re), (header.negative & 1u) != 0};
+    m_view.centerIm = BigFloat {std::move(im), (header.negative & 2u) != 0};
+    m_view.span = std::ldexp(static_cast<long double>(header.spanHigh) + header.spanLow, header.spanExponent);
+    m_view.maxIterations = static_cast<int>(header.maxIterations);
+    m_view.size = {static_cast<int>(header.width), static_cast<int>(header.height)};
+    m_rowsWritten = static_cast<int>(header.rows);
+    return true;
+}
+
+/**
+ * Copy the band into the mapping row by row on all threads, the pages are written back by the system.
+ * Bands are expected top to bottom: the stored row count is raised to the bottom of the band.
+ */
+void IterationFile::write_rows(int top, int rows, const int* iterations, const float* fractions) {
+    const size_t width {static_cast<size_t>(m_view.size.x)};
+    std::uint8_t* counts {channel(Iterations)};
+    std::uint8_t* smooth {fractions != nullptr ? channel(Smooth) : nullptr};
+
+#pragma omp parallel for default(none) shared(top, rows, iterations, fractions, width, counts, smooth)
+    for (int y = 0; y < rows; ++y) {
+        const size_t source {static_cast<size_t>(y) * width};
+        const size_t target {static_cast<size_t>(top + y) * width};
+        if (counts != nullptr) {
+            std::memcpy(counts + target * 4, iterations + source, width * 4);
+        }
+        if (smooth != nullptr) {
+            std::memcpy(smooth + target * 4, fractions + source, width * 4);
+        }
+    }
+
+    m_rowsWritten = std::max(m_rowsWritten, top + rows);
+    const auto stored {static_cast<std::uint32_t>(m_rowsWritten)};
+    std::memcpy(m_file.data() + offsetof(Header, rows), &stored, sizeof(stored));
+}
+
+bool IterationFile::flush() {
+    return m_file.flush();
+}
+
+void IterationFile::close() {
+    m_file.close();
+    m_channels = 0;
+    m_rowsWritten = 0;
+    std::fill(std::begin(m_offsets), std::end(m_offsets), 0);
+}
+
+const std::uint8_t* IterationFile::channel(Channel channel) const {
+    const std::uint64_t offset {m_offsets[index_of(channel)]};
+    return offset != 0 ? m_file.data() + offset : nullptr;
+}
+
+std::uint8_t* IterationFile::channel(Channel channel) {
+    const std::uint64_t offset {m_offsets[index_of(channel)]};
+    return offset != 0 ? m_file.data() + offset : nullptr;
+}
+
+const IterationFile::View& IterationFile::get_view() const {
+    return m_view;
+}
+
+bool IterationFile::has_channel(Channel channel) const {
+    return (m_channels & channel) != 0;
+}
+
+bool IterationFile::is_open() const {
+    return m_file.is_open();
+}
+
+int IterationFile::get_rows_written() const {
+    return m_rowsWritten;
+}
+
+const std::int32_t* IterationFile::get_iterations() const {
+    return reinterpret_cast<const std::int32_t*>(channel(Iterations));
+}
+
+const float* IterationFile::get_fractions() const {
+    return reinterpret_cast<const float*>(channel(Smooth));
+}
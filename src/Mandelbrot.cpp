@@ -2,149 +2,1192 @@
 // Created by HORIA on 17.02.2023.
 //
 #include "Mandelbrot.h"
+#include "SimdKernel.h"
 
-void Mandelbrot::init_variables() {
-    m_image.create(m_width, m_height);
-    if (!m_texture.create(m_width, m_height))
-        assert("Failed to create texture");
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+void Mandelbrot::set_color(int iters, int x, int y) {
+
+    // Look up the precomputed color for this iteration count, points in the set map to black
+    m_framebuffer.set_pixel(x, y, m_palette.color(iters));
+}
+
+/**
+ * Store the result of the pixel at x, y, it is colored by the next coloring pass.
+ *
+ * @param norm |z|^2 at the iteration the pixel escaped, only used for smooth coloring.
+ */
+void Mandelbrot::set_result(int iters, int x, int y, sf::Vector2i screen, double norm) {
+    const size_t index {static_cast<size_t>(y) * screen.x + x};
+    m_iterations[index] = iters;
+    if (!m_fractions.empty()) {
+        m_fractions[index] = smooth_fraction(norm);
+    }
+}
+
+/**
+ * Continuous part of the escape count: |z| at escape lies between the escape radius 2 and about its square,
+ * 1 - log2(log2 |z|) maps that range onto [0, 1] so that the count plus the fraction has no steps.
+ */
+float Mandelbrot::smooth_fraction(double norm) {
+    if (!(norm > 4.0)) {
+        return 0.0f;
+    }
+    return static_cast<float>(std::clamp(1.0 - std::log2(0.5 * std::log2(norm)), 0.0, 1.0));
 }
 
-sf::Color Mandelbrot::interpolate_color(double colorIndex, const std::vector<sf::Color>& colors) {
+bool Mandelbrot::is_missing(int x, int y, sf::Vector2i screen) const {
+    return m_iterations[static_cast<size_t>(y) * screen.x + x] == Missing;
+}
 
-    // Determine the maximum color index based on the number of colors in the provided vector
-    const auto maxColor {colors.size() - 1};
+/**
+ * Number of rows the view is divided into, the screen's unless only a band of the frame is rendered.
+ */
+int Mandelbrot::frame_height(sf::Vector2i screen) const {
+    return m_frameHeight > 0 ? m_frameHeight : screen.y;
+}
 
-    // Determine the maximum color index based on the number of colors in the provided vector
-    colorIndex *= maxColor;
+/**
+ * Generate the Mandelbrot set and store it in the object's framebuffer.
+ *
+ * @param screen The size of the output screen.
+ * @param cancel Checked between tiles, a cancelled frame returns early and leaves the image partly updated.
+ * @param onPass Called after every progressive pass but the last, may be empty.
+ */
+void Mandelbrot::mandy(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass) {
+    m_preview = false;
+
+    // The frame is colored in place, nothing is allocated before the first frame or again until the size changes
+    m_framebuffer.resize(screen);
 
-    // Determine the lower index by casting down the color index to the nearest integer
-    auto lowerIndex {static_cast<size_t>(colorIndex)};
+    // Rebuild the color lookup table once per frame if the palette or the iteration limit changed
+    if (!m_palette.is_built_for(m_maxIterations)) {
+        m_palette.build(m_maxIterations);
+    }
+
+    // Render with the cheapest arithmetic that still resolves neighbouring pixels
+    m_precision = select_precision(screen);
 
-    // Get the colors corresponding to the lower and upper color indices
-    auto color1 {colors[lowerIndex]};
-    auto color2 {colors[std::clamp(lowerIndex + 1, size_t{0}, colors.size() - 1)]};
+    // Cached tiles are looked up on the pixel lattice of the view, bands of a larger frame are not cached
+    const bool caching {m_tileCaching && m_frameHeight == 0};
+    if (caching) {
+        find_lattice(screen);
+    }
 
-    // Interpolate the color between the two colors based on the color index and the lower index
-    return linear_interp(color1, color2, colorIndex - lowerIndex);
+    // Keep what the stored counts of the last frame still cover, only the missing pixels are rendered
+    const int storedLimit {m_iterationsLimit};
+    if (!reuse_iterations(screen, cancel)) {
+        m_iterations.assign(static_cast<size_t>(screen.x) * screen.y, Missing);
+        if (m_smoothColoring) {
+            m_fractions.assign(m_iterations.size(), 0.0f);
+        } else {
+            m_fractions.clear();
+        }
+        m_iterationsLimit = m_maxIterations;
+        m_iterationsScreen = screen;
+        m_iterationsPrecision = m_precision;
+        m_pending.clear();
+        m_resumable = m_precision == Precision::Float || m_precision == Precision::Double;
+    }
+
+    // A cancelled frame leaves the pixels it did not get to missing, the next frame picks them up
+    if (cancel.is_cancelled()) {
+        return;
+    }
+
+    // Tiles seen before fill in what they cover, only the pixels none of them has are rendered
+    const auto hasMissing = [this] {
+        return std::find(m_iterations.begin(), m_iterations.end(), Missing) != m_iterations.end();
+    };
+    bool missing {hasMissing()};
+    if (caching && missing) {
+        fill_from_cache(screen);
+        missing = hasMissing();
+    }
+    if (missing) {
+        render_missing(screen, cancel, onPass);
+    }
+
+    // New results go to the cache, a cancelled frame hands over the pixels it finished
+    if (caching && (missing || m_iterationsLimit != storedLimit)) {
+        store_in_cache(screen);
+    }
+    if (cancel.is_cancelled()) {
+        return;
+    }
+
+    // Coloring is a pass of its own over the stored results, a new palette only has to repeat it
+    colorize(screen);
 }
 
-void Mandelbrot::set_color(int iters, int x, int y) {
+/**
+ * Render the pixels without a stored result with the arithmetic tier picked for the frame.
+ */
+void Mandelbrot::render_missing(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass) {
+    switch (m_precision) {
+        case Precision::Float:
+            mandy_simd<float>(screen, cancel, onPass);
+            break;
+        case Precision::Double:
+            mandy_simd<double>(screen, cancel, onPass);
+            break;
+        case Precision::LongDouble:
+            mandy_scalar<long double>(screen, cancel, onPass);
+            break;
+        case Precision::DoubleDouble:
+            mandy_scalar<DoubleDouble>(screen, cancel, onPass);
+            break;
+        case Precision::Perturbation:
+            mandy_perturbation(screen, cancel, onPass);
+            break;
+    }
+}
+
+/**
+ * Forget the stored escape counts, they no longer match the view or the settings.
+ */
+void Mandelbrot::invalidate_iterations() {
+    m_iterationsLimit = 0;
+    m_pending.clear();
+}
 
-    // Define a vector of colors to use for coloring the Mandelbrot set
-    const std::vector<sf::Color> colors {
-            {0,0,0},
-            {255,0,0},
-            {255,127,0},
-            {255,255,0},
-            {0,255,0},
-            {0,0,255},
-            {75,0,130},
-            {148,0,211},
-            {255,0,255},
-            {255,255,255}
+/**
+ * Find the cached lattice the view lies on, or start a new one at the view. A view lies on a lattice when
+ * its pixel spacing matches and its top left pixel is a whole number of lattice pixels away, both closely
+ * enough that no pixel of it is off by more than PixelTolerance, the same slack pans and zoom outs get.
+ * The view itself is left as it is.
+ *
+ * @param screen The size of the output screen.
+ */
+void Mandelbrot::find_lattice(sf::Vector2i screen) {
+    const SpanType spacingRe {m_spanRe / static_cast<long double>(screen.x)};
+    const SpanType spacingIm {m_spanIm / static_cast<long double>(screen.y)};
+    const CoordType minRe {m_centerRe - to_coord(m_spanRe / 2)};
+    const CoordType minIm {m_centerIm - to_coord(m_spanIm / 2)};
+
+    // Index of the top left pixel on one axis of the lattice, false if the view is off the lattice
+    const auto index = [](const CoordType& offset, const SpanType& spacing, const SpanType& latticeSpacing,
+                          int pixels, std::int64_t& result) {
+        const auto exact {static_cast<long double>(static_cast<SpanType>(offset) / latticeSpacing)};
+        const long double rounded {std::round(exact)};
+        const long double drift {std::abs(static_cast<long double>(spacing / latticeSpacing) - 1.0L) * pixels};
+        if (!(std::abs(exact) < MaxLatticeOffset) || std::abs(exact - rounded) + drift > PixelTolerance) {
+            return false;
+        }
+        result = static_cast<std::int64_t>(rounded);
+        return true;
     };
 
-    // If the number of iterations is equal to the maximum number of iterations, the point is considered to be in the set
-    // and is assigned the default color (black)
-    if (iters == m_maxIterations) {
-        iters = 0;
+    for (auto lattice = m_lattices.begin(); lattice != m_lattices.end(); ++lattice) {
+        if (index(minRe - lattice->minRe, spacingRe, lattice->spacingRe, screen.x, m_gridX) &&
+            index(minIm - lattice->minIm, spacingIm, lattice->spacingIm, screen.y, m_gridY)) {
+            m_gridLattice = lattice->id;
+            std::rotate(m_lattices.begin(), lattice, std::next(lattice));
+            return;
+        }
+    }
+
+    if (m_lattices.size() >= MaxLattices) {
+        m_lattices.pop_back();
+    }
+    m_gridLattice = m_nextLattice++;
+    m_gridX = 0;
+    m_gridY = 0;
+    m_lattices.insert(m_lattices.begin(), {m_gridLattice, minRe, minIm, spacingRe, spacingIm});
+}
+
+/**
+ * What the results of the current frame depend on besides the view and the iteration limit: the kernel
+ * shortcuts, the arithmetic tier and whether fractions are kept. Tiles computed any other way are not reused.
+ */
+std::uint32_t Mandelbrot::tile_formula() const {
+    return kernel_flags() | static_cast<std::uint32_t>(m_precision) << 8 | (m_fractions.empty() ? 0u : 1u << 16);
+}
+
+/**
+ * List the cache tiles of the frame's lattice that overlap the frame.
+ *
+ * @param create Whether tiles not in the cache are added to it, otherwise they are left out.
+ */
+std::vector<Mandelbrot::GridTile> Mandelbrot::grid_tiles(sf::Vector2i screen, bool create) {
+    // Tile indices round towards minus infinity, the grid extends to negative indices
+    const auto tileOf = [](std::int64_t pixel) {
+        return pixel >= 0 ? pixel / TileCache::Size : -((-pixel + TileCache::Size - 1) / TileCache::Size);
+    };
+
+    std::vector<GridTile> tiles {};
+    const std::uint32_t formula {tile_formula()};
+    for (std::int64_t ty = tileOf(m_gridY); ty <= tileOf(m_gridY + screen.y - 1); ++ty) {
+        for (std::int64_t tx = tileOf(m_gridX); tx <= tileOf(m_gridX + screen.x - 1); ++tx) {
+            const TileCache::Key key {m_gridLattice, tx, ty, m_maxIterations, formula};
+            TileCache::Tile* tile {create ? &m_tileCache.insert(key, !m_fractions.empty()) : m_tileCache.find(key)};
+            if (tile != nullptr) {
+                tiles.push_back({tile, static_cast<int>(tx * TileCache::Size - m_gridX),
+                                 static_cast<int>(ty * TileCache::Size - m_gridY)});
+            }
+        }
+    }
+    return tiles;
+}
+
+/**
+ * Give the missing pixels the results the cached tiles hold for them. Cached pixels still running at the
+ * limit have no orbits to resume, if there are any a higher limit renders the next frame anew.
+ */
+void Mandelbrot::fill_from_cache(sf::Vector2i screen) {
+    const std::vector<GridTile> tiles {grid_tiles(screen, false)};
+    const bool smooth {!m_fractions.empty()};
+    bool running {};
+
+#pragma omp parallel for default(none) shared(screen, tiles, smooth) reduction(|| : running)
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const GridTile& tile {tiles[i]};
+        for (int y = std::max(tile.y, 0); y < std::min(tile.y + TileCache::Size, screen.y); ++y) {
+            for (int x = std::max(tile.x, 0); x < std::min(tile.x + TileCache::Size, screen.x); ++x) {
+                const size_t index {static_cast<size_t>(y) * screen.x + x};
+                const size_t source {static_cast<size_t>(y - tile.y) * TileCache::Size + (x - tile.x)};
+                if (m_iterations[index] != Missing || tile.tile->iterations[source] == Missing) {
+                    continue;
+                }
+                m_iterations[index] = tile.tile->iterations[source];
+                if (smooth) {
+                    m_fractions[index] = tile.tile->fractions[source];
+                }
+                running = running || m_iterations[index] == m_maxIterations;
+            }
+        }
     }
 
-    // Calculate the value of mu, which is a value between 0 and 1 that is used to determine the color of the point
-    double mu {1.0 * iters / m_maxIterations};
+    if (running) {
+        m_pending.clear();
+        m_resumable = false;
+    }
+}
 
-    // Calculate the value of mu, which is a value between 0 and 1 that is used to determine the color of the point
-    auto color {interpolate_color(mu, colors)};
+/**
+ * Copy the finished pixels of the frame into the tiles of its lattice. A frame needing more tiles than the
+ * cache holds is not stored, it would evict its own tiles.
+ */
+void Mandelbrot::store_in_cache(sf::Vector2i screen) {
+    const std::int64_t columns {(screen.x + TileCache::Size - 1) / TileCache::Size + 1};
+    const std::int64_t rows {(screen.y + TileCache::Size - 1) / TileCache::Size + 1};
+    if (m_iterationsLimit != m_maxIterations || static_cast<size_t>(columns * rows) > m_tileCache.get_capacity()) {
+        return;
+    }
+
+    const std::vector<GridTile> tiles {grid_tiles(screen, true)};
+    const bool smooth {!m_fractions.empty()};
 
-    // Set the color of the pixel at (x, y) in the Mandelbrot image
-    m_image.setPixel(x, y, color);
+#pragma omp parallel for default(none) shared(screen, tiles, smooth)
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const GridTile& tile {tiles[i]};
+        for (int y = std::max(tile.y, 0); y < std::min(tile.y + TileCache::Size, screen.y); ++y) {
+            for (int x = std::max(tile.x, 0); x < std::min(tile.x + TileCache::Size, screen.x); ++x) {
+                const size_t index {static_cast<size_t>(y) * screen.x + x};
+                const size_t target {static_cast<size_t>(y - tile.y) * TileCache::Size + (x - tile.x)};
+                if (m_iterations[index] == Missing) {
+                    continue;
+                }
+                tile.tile->iterations[target] = m_iterations[index];
+                if (smooth) {
+                    tile.tile->fractions[target] = m_fractions[index];
+                }
+            }
+        }
+    }
 }
 
 /**
- * Generate the Mandelbrot set and store it in the object's color buffer.
+ * Bring the stored escape counts to the current iteration limit, if they still belong to the view. A lower
+ * limit only recolors them, points that ran past it count as bounded. A higher limit continues the pixels
+ * still running at the old one from their orbits, the others keep their counts.
+ * Pixels without a count stay missing for the caller to render.
  *
  * @param screen The size of the output screen.
+ * @param cancel Checked between batches of resumed pixels, a cancelled resume leaves the stored counts as they were.
+ * @return Whether the stored counts were kept, false when the frame has to be rendered from scratch.
  */
-void Mandelbrot::mandy(sf::Vector2i screen) {
+bool Mandelbrot::reuse_iterations(sf::Vector2i screen, const CancellationToken& cancel) {
+    if (m_iterationsLimit == 0 || screen != m_iterationsScreen || m_precision != m_iterationsPrecision) {
+        return false;
+    }
+
+    if (m_maxIterations < m_iterationsLimit &&
+        std::find(m_iterations.begin(), m_iterations.end(), Missing) != m_iterations.end()) {
+
+        // The missing pixels get counts for the lower limit, so the others are cut to it as well and the
+        // orbits kept for the old limit can no longer be resumed
+        for (int& iters : m_iterations) {
+            if (iters != SimdKernel::Settled) {
+                iters = std::min(iters, m_maxIterations);
+            }
+        }
+        m_iterationsLimit = m_maxIterations;
+        m_pending.clear();
+        m_resumable = false;
+    } else if (m_maxIterations > m_iterationsLimit) {
+        if (!m_resumable) {
+            return false;
+        }
 
-    using CoordType = long double;
+        if (m_precision == Precision::Float) {
+            resume_simd<float>(screen, cancel);
+        } else {
+            resume_simd<double>(screen, cancel);
+        }
+        if (cancel.is_cancelled()) {
+            return true;
+        }
+        m_iterationsLimit = m_maxIterations;
+    }
 
-    // OpenMP parallelize this loop to utilize multiple threads
-#pragma omp parallel for default(none) shared(screen)
+    return true;
+}
 
-    // Iterate over the screen's pixels
+/**
+ * Color every pixel from its stored result. While a progressive frame is under way, a missing pixel takes
+ * the result at the top left of its step x step block, the pixel the last pass computed for it. Pixels
+ * without either keep their color.
+ *
+ * @param screen The size of the output screen.
+ * @param step Spacing of the last finished pass, a power of two.
+ */
+void Mandelbrot::colorize(sf::Vector2i screen, int step) {
+    const bool smooth {m_smoothColoring && !m_fractions.empty()};
+
+#pragma omp parallel for default(none) shared(screen, step, smooth)
     for (int y = 0; y < screen.y; ++y) {
         for (int x = 0; x < screen.x; ++x) {
+            size_t index {static_cast<size_t>(y) * screen.x + x};
+            if (m_iterations[index] == Missing) {
+                index = static_cast<size_t>(y & -step) * screen.x + (x & -step);
+            }
+
+            const int iters {m_iterations[index]};
+            if (iters == Missing) {
+                continue;
+            }
+            if (smooth) {
+                m_framebuffer.set_pixel(x, y, m_palette.color(iters, m_fractions[index]));
+            } else {
+                set_color(iters, x, y);
+            }
+        }
+    }
+}
+
+/**
+ * Stretch the image of the last frame over the view a zoom leads to, as a stand-in until the new frame is
+ * rendered. Every pixel takes the color of the nearest sample of the old view, pixels the old view does not
+ * cover turn black. The passes of the next frame paint over all of it, none of it counts as a result.
+ *
+ * @param fractionX Horizontal position of the new center in the old view, 0 is the left edge.
+ * @param fractionY Vertical position of the new center in the old view, 0 is the top edge.
+ * @param zoomFactor Magnification of the new view, below 1 zooms out.
+ */
+void Mandelbrot::reproject_image(long double fractionX, long double fractionY, long double zoomFactor) {
+    const int width {m_framebuffer.get_size().x};
+    const int height {m_framebuffer.get_size().y};
+
+    // Pixel x of the new view lies at fractionX + (x / width - 1 / 2) / zoomFactor of the old one, the
+    // nearest old column is looked up once for the whole frame
+    const double scale {1.0 / static_cast<double>(zoomFactor)};
+    const double originX {static_cast<double>(fractionX) * width - width / 2.0 * scale};
+    const double originY {static_cast<double>(fractionY) * height - height / 2.0 * scale};
+    std::vector<long> sourceColumns(width);
+    for (int x = 0; x < width; ++x) {
+        sourceColumns[x] = std::lround(originX + x * scale);
+    }
+
+    // Pixels outside the old view turn black
+    const sf::Uint8 black[4] {0, 0, 0, 255};
+    Framebuffer pixels {m_framebuffer.get_size()};
+#pragma omp parallel for default(none) shared(width, height, scale, originY, sourceColumns, black, pixels)
+    for (int y = 0; y < height; ++y) {
+        const long sourceY {std::lround(originY + y * scale)};
+        const bool inside {sourceY >= 0 && sourceY < height};
+        const sf::Uint8* sourceRow {m_framebuffer.row(inside ? static_cast<int>(sourceY) : 0)};
+        sf::Uint8* row {pixels.row(y)};
+        for (int x = 0; x < width; ++x) {
+            const bool covered {inside && sourceColumns[x] >= 0 && sourceColumns[x] < width};
+            std::memcpy(row + x * 4, covered ? sourceRow + sourceColumns[x] * 4 : black, 4);
+        }
+    }
+    m_framebuffer = std::move(pixels);
+    m_preview = true;
+}
+
+/**
+ * Carry the stored escape counts over to a new view whose pixels are a subset of the old samples: a pan by
+ * a whole number of pixels, or a zoom out by a whole factor whose grid lines up with the old one. Pixels
+ * the old view does not cover are left missing for the next frame to render, any other change of view
+ * discards the counts.
+ *
+ * @param fractionX Horizontal position of the new view's left edge in the old view, 1 is a full view width.
+ * @param fractionY Vertical position of the new view's top edge in the old view, 1 is a full view height.
+ * @param scale Width of the new view in old views, 1 for a pan.
+ */
+void Mandelbrot::remap_iterations(long double fractionX, long double fractionY, long double scale) {
+    if (m_iterationsLimit == 0) {
+        return;
+    }
+
+    // Pixel x, y of the new view is pixel originX + x * step, originY + y * step of the old one
+    const int width {m_iterationsScreen.x};
+    const int height {m_iterationsScreen.y};
+    const long double exactX {fractionX * width};
+    const long double exactY {fractionY * height};
+    const long originX {std::lround(exactX)};
+    const long originY {std::lround(exactY)};
+    const long step {std::lround(scale)};
+
+    if (step < 1 || std::abs(scale - step) > PixelTolerance || std::abs(exactX - originX) > PixelTolerance ||
+        std::abs(exactY - originY) > PixelTolerance) {
+        invalidate_iterations();
+        return;
+    }
+
+    // The smooth fractions, when kept, move the same way as the counts
+    const auto remap = [&](auto& buffer, auto fill) {
+        std::remove_reference_t<decltype(buffer)> remapped(buffer.size(), fill);
+#pragma omp parallel for default(none) shared(width, height, originX, originY, step, buffer, remapped)
+        for (int y = 0; y < height; ++y) {
+            const long sourceY {originY + y * step};
+            if (sourceY < 0 || sourceY >= height) {
+                continue;
+            }
+            const auto* source {&buffer[static_cast<size_t>(sourceY) * width]};
+            auto* row {&remapped[static_cast<size_t>(y) * width]};
+            for (int x = 0; x < width; ++x) {
+                const long sourceX {originX + x * step};
+                if (sourceX >= 0 && sourceX < width) {
+                    row[x] = source[sourceX];
+                }
+            }
+        }
+        buffer.swap(remapped);
+    };
+    remap(m_iterations, Missing);
+    if (!m_fractions.empty()) {
+        remap(m_fractions, 0.0f);
+    }
+
+    // Orbits of the kept pixels move along, the others are gone
+    std::vector<PendingPixel> pending {};
+    for (const PendingPixel& pixel : m_pending) {
+        const long offsetX {pixel.index % width - originX};
+        const long offsetY {pixel.index / width - originY};
+        if (offsetX % step != 0 || offsetY % step != 0) {
+            continue;
+        }
+        const long x {offsetX / step};
+        const long y {offsetY / step};
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            pending.push_back({static_cast<int>(y * width + x), pixel.orbit});
+        }
+    }
+    m_pending.swap(pending);
+}
+
+/**
+ * Continue the pixels still running at the stored limit up to the current one with the vector kernel.
+ * Results are only committed once every batch is done, so a cancelled resume can be repeated later.
+ *
+ * @param screen The size of the output screen.
+ * @param cancel Checked before every batch.
+ */
+template<typename T>
+void Mandelbrot::resume_simd(sf::Vector2i screen, const CancellationToken& cancel) {
+
+    // Same conversion as mandy_simd, so a resumed pixel gets the coordinates it was started with
+    const T minRe {static_cast<T>(m_centerRe - to_coord(m_spanRe / 2))};
+    const T minIm {static_cast<T>(m_centerIm - to_coord(m_spanIm / 2))};
+    const T spanRe {static_cast<T>(static_cast<long double>(m_spanRe))};
+    const T spanIm {static_cast<T>(static_cast<long double>(m_spanIm))};
+
+    const int top {m_bandTop};
+    const int frameHeight {frame_height(screen)};
+    const unsigned flags {kernel_flags()};
+    const int count {static_cast<int>(m_pending.size())};
+    const bool smooth {!m_fractions.empty()};
+    std::vector<int> results(count);
+    std::vector<double> norms(smooth ? count : 0);
+    std::vector<SimdKernel::Orbit<double>> resumed(count);
+
+    // Pending pixels were collected a tile at a time, so neighbouring entries lie close together on the plane
+#pragma omp parallel for schedule(dynamic) default(none) \
+    shared(screen, minRe, minIm, spanRe, spanIm, top, frameHeight, flags, count, smooth, results, norms, resumed, cancel)
+    for (int start = 0; start < count; start += ResumeBatch) {
+        if (cancel.is_cancelled()) {
+            continue;
+        }
+
+        T realCoords[ResumeBatch];
+        T imagCoords[ResumeBatch];
+        SimdKernel::Orbit<T> orbits[ResumeBatch];
+        T escapeNorms[ResumeBatch];
+        const int size {std::min(ResumeBatch, count - start)};
+
+        for (int i = 0; i < size; ++i) {
+            const PendingPixel& pixel {m_pending[start + i]};
+            realCoords[i] = minRe + spanRe * (pixel.index % screen.x) / screen.x;
+            imagCoords[i] = minIm + spanIm * (top + pixel.index / screen.x) / frameHeight;
+            orbits[i] = {static_cast<T>(pixel.orbit.re), static_cast<T>(pixel.orbit.im),
+                         static_cast<T>(pixel.orbit.savedRe), static_cast<T>(pixel.orbit.savedIm)};
+        }
+
+        SimdKernel::escape_time(realCoords, imagCoords, size, m_maxIterations, &results[start], flags, orbits,
+                                m_iterationsLimit, smooth ? escapeNorms : nullptr);
+
+        for (int i = 0; i < size; ++i) {
+            resumed[start + i] = {orbits[i].re, orbits[i].im, orbits[i].savedRe, orbits[i].savedIm};
+            if (smooth) {
+                norms[start + i] = escapeNorms[i];
+            }
+        }
+    }
+    if (cancel.is_cancelled()) {
+        return;
+    }
+
+    // Keep the pixels that are still running at the new limit
+    std::vector<PendingPixel> pending {};
+    for (int i = 0; i < count; ++i) {
+        m_iterations[m_pending[i].index] = results[i];
+        if (smooth) {
+            m_fractions[m_pending[i].index] = smooth_fraction(norms[i]);
+        }
+        if (results[i] == m_maxIterations) {
+            pending.push_back({m_pending[i].index, resumed[i]});
+        }
+    }
+    m_pending.swap(pending);
+}
+
+/**
+ * Pick the cheapest arithmetic tier for the current view.
+ * A tier is good enough while the pixel spacing stays about 10 bits above the rounding error of the
+ * largest coordinate, so neighbouring pixels never collapse onto the same value.
+ *
+ * @param screen The size of the output screen.
+ */
+Mandelbrot::Precision Mandelbrot::select_precision(sf::Vector2i screen) const {
+    const SpanType spacing {std::min(m_spanRe / screen.x, m_spanIm / frame_height(screen))};
+    const long double magnitude {std::max({std::abs(static_cast<long double>(m_centerRe)) + static_cast<long double>(m_spanRe) / 2,
+                                           std::abs(static_cast<long double>(m_centerIm)) + static_cast<long double>(m_spanIm) / 2,
+                                           1.0L})};
+
+    const auto fits = [&](long double epsilon) {
+        return spacing > SpanType {magnitude * epsilon * 1024};
+    };
+
+    if (fits(std::numeric_limits<float>::epsilon())) {
+        return Precision::Float;
+    }
+    if (fits(std::numeric_limits<double>::epsilon())) {
+        return Precision::Double;
+    }
+
+    // long double is only a separate tier where it is wider than double (x87 extended precision)
+    if (std::numeric_limits<long double>::digits > std::numeric_limits<double>::digits &&
+        fits(std::numeric_limits<long double>::epsilon())) {
+        return Precision::LongDouble;
+    }
+    return m_perturbation ? Precision::Perturbation : Precision::DoubleDouble;
+}
+
+/**
+ * Shortcuts the escape-time kernels may take for the current settings.
+ */
+unsigned Mandelbrot::kernel_flags() const {
+    return (m_interiorCheck ? SimdKernel::SkipInterior : SimdKernel::None) |
+           (m_periodicityCheck ? SimdKernel::DetectPeriod : SimdKernel::None);
+}
+
+/**
+ * Run the work for every tile once per pass, from the coarsest pass to the full resolution one.
+ * Every pass computes only pixels no earlier pass did, but the block fills of the preview passes still cost
+ * extra writes, so without a callback to show them the frame is rendered in a single pass.
+ *
+ * @param screen The size of the output screen.
+ * @param cancel Checked between tiles, no further passes start once it is cancelled.
+ * @param onPass Called after every pass but the last, may be empty.
+ * @param work Computes the pixels of a tile that belong to the pass.
+ */
+void Mandelbrot::run_passes(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass,
+                            const std::function<void(const TileScheduler::Tile&, const Pass&)>& work) {
+    const int firstStep {m_progressive && onPass ? CoarsestStep : 1};
+
+    for (int step = firstStep; step >= 1; step /= 2) {
+        const Pass pass {step, step != firstStep};
+        m_scheduler.run(screen, TileSize, [&](const TileScheduler::Tile& tile) { work(tile, pass); }, cancel);
+
+        if (cancel.is_cancelled()) {
+            return;
+        }
+        if (step > 1) {
+            colorize(screen, step);
+            onPass();
+        }
+    }
+}
+
+/**
+ * Generate the set a tile at a time with the vector kernel of the given precision.
+ *
+ * @param screen The size of the output screen.
+ */
+template<typename T>
+void Mandelbrot::mandy_simd(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass) {
+
+    // Convert the view to the working precision once per frame
+    const T minRe {static_cast<T>(m_centerRe - to_coord(m_spanRe / 2))};
+    const T minIm {static_cast<T>(m_centerIm - to_coord(m_spanIm / 2))};
+    const T spanRe {static_cast<T>(static_cast<long double>(m_spanRe))};
+    const T spanIm {static_cast<T>(static_cast<long double>(m_spanIm))};
+
+    const int top {m_bandTop};
+    const int frameHeight {frame_height(screen)};
+    const unsigned flags {kernel_flags()};
+    const bool smooth {!m_fractions.empty()};
 
-            // Calculate the coordinates of the current pixel on the complex plane
-            CoordType realCoord {m_minRe + (m_maxRe - m_minRe) * x / screen.x};
-            CoordType imagCoord {m_minIm + (m_maxIm - m_minIm) * y / screen.y};
+    // Tiles are spread over the scheduler's threads, a tile fits into buffers on the stack
+    run_passes(screen, cancel, onPass, [&](const TileScheduler::Tile& tile, const Pass& pass) {
+        T columnCoords[TileSize];
+        T rowCoords[TileSize];
+        // A pass fills only some of the entries, the rest start at zero so the kernel never sees garbage
+        T realCoords[TileSize * TileSize] {};
+        T imagCoords[TileSize * TileSize] {};
+        sf::Vector2i pixels[TileSize * TileSize];
+        int iterations[TileSize * TileSize];
+        T norms[TileSize * TileSize];
+        SimdKernel::Orbit<T> orbits[TileSize * TileSize];
 
-            // Initialize the real and imaginary parts of the complex number to 0
-            CoordType realComponent {0.0}, imagComponent {0.0};
-            int iters {};
+        // Calculate the coordinates of the tile's columns and rows
+        for (int i = 0; i < tile.width; ++i) {
+            columnCoords[i] = minRe + spanRe * (tile.x + i) / screen.x;
+        }
+        for (int i = 0; i < tile.height; ++i) {
+            rowCoords[i] = minIm + spanIm * (top + tile.y + i) / frameHeight;
+        }
+
+        // Gather the pixels of the pass in bands two grid rows high, so the pixels sharing a vector
+        // stay close together on the plane even when the pass skips every other one in a row
+        int count {};
+        for (int y = tile.y; y < tile.y + tile.height; y += 2 * pass.step) {
+            const int bandEnd {std::min(y + 2 * pass.step, tile.y + tile.height)};
+            for (int x = tile.x; x < tile.x + tile.width; x += pass.step) {
+                for (int row = y; row < bandEnd; row += pass.step) {
+                    if (pass.computes(x, row) && is_missing(x, row, screen)) {
+                        pixels[count] = {x, row};
+                        realCoords[count] = columnCoords[x - tile.x];
+                        imagCoords[count++] = rowCoords[row - tile.y];
+                    }
+                }
+            }
+        }
+
+        SimdKernel::escape_time(realCoords, imagCoords, count, m_maxIterations, iterations, flags, orbits, 0,
+                                smooth ? norms : nullptr);
+
+        // Store the number of iterations of the pixels
+        std::vector<PendingPixel> pending {};
+        for (int i = 0; i < count; ++i) {
+            set_result(iterations[i], pixels[i].x, pixels[i].y, screen, smooth ? norms[i] : 0.0);
+
+            // Pixels still running at the limit are kept for a higher one
+            if (iterations[i] == m_maxIterations) {
+                pending.push_back({pixels[i].y * screen.x + pixels[i].x,
+                                   {orbits[i].re, orbits[i].im, orbits[i].savedRe, orbits[i].savedIm}});
+            }
+        }
+
+        if (!pending.empty()) {
+            std::lock_guard<std::mutex> lock {m_pendingMutex};
+            m_pending.insert(m_pending.end(), pending.begin(), pending.end());
+        }
+    });
+}
 
-            // Perform the iterative calculation to determine whether the current point
-            // is in the Mandelbrot set or not
-            for (iters = 0; iters < m_maxIterations; ++iters) {
+/**
+ * Generate the set one pixel at a time, used for the tiers without a vector kernel.
+ *
+ * @param screen The size of the output screen.
+ */
+template<typename T>
+void Mandelbrot::mandy_scalar(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass) {
+
+    // Convert the view to the working precision once per frame
+    const T minRe {static_cast<T>(m_centerRe - to_coord(m_spanRe / 2))};
+    const T minIm {static_cast<T>(m_centerIm - to_coord(m_spanIm / 2))};
+    const T spanRe {static_cast<T>(static_cast<long double>(m_spanRe))};
+    const T spanIm {static_cast<T>(static_cast<long double>(m_spanIm))};
 
-                // Calculate the next point in the sequence
-                CoordType tr {realComponent * realComponent - imagComponent * imagComponent + realCoord};
-                imagComponent = 2 * realComponent * imagComponent + imagCoord;
-                realComponent = tr;
+    const int top {m_bandTop};
+    const int frameHeight {frame_height(screen)};
+    const unsigned flags {kernel_flags()};
+    const bool smooth {!m_fractions.empty()};
 
-                // If the point is outside the circle of radius 2, exit the loop early
-                if (realComponent * realComponent + imagComponent * imagComponent > 2 * 2) {
-                    break;
+    // Iterate over the pixels of every tile, the scheduler balances the tiles over its threads
+    run_passes(screen, cancel, onPass, [&](const TileScheduler::Tile& tile, const Pass& pass) {
+        for (int y = tile.y; y < tile.y + tile.height; y += pass.step) {
+            for (int x = tile.x; x < tile.x + tile.width; x += pass.step) {
+                if (!pass.computes(x, y) || !is_missing(x, y, screen)) {
+                    continue;
                 }
+
+                // Calculate the coordinates of the current pixel on the complex plane
+                T realCoord {minRe + spanRe * x / screen.x};
+                T imagCoord {minIm + spanIm * (top + y) / frameHeight};
+
+                // Store the number of iterations of the current pixel
+                T norm {};
+                const int iters {SimdKernel::iterate<T>(realCoord, imagCoord, m_maxIterations, flags, nullptr, 0,
+                                                        smooth ? &norm : nullptr)};
+                set_result(iters, x, y, screen, static_cast<double>(norm));
             }
-            // Set the color of the current pixel based on the number of iterations
-            set_color(iters, x, y);
         }
+    });
+}
+
+/**
+ * Generate the set with perturbation: one reference orbit is iterated in arbitrary precision and every
+ * pixel only tracks its double precision offset from it. The reference is reused across frames while it
+ * stays near the view, is precise enough for the pixel spacing and covers the iteration limit.
+ *
+ * @param screen The size of the output screen.
+ */
+void Mandelbrot::mandy_perturbation(sf::Vector2i screen, const CancellationToken& cancel, const PassCallback& onPass) {
+
+    const int top {m_bandTop};
+    const int frameHeight {frame_height(screen)};
+    const int precision {BigFloat::precision_for(std::min(m_spanRe / screen.x, m_spanIm / frameHeight))};
+
+    // Offset of the view center from the previous reference, in units of the view size
+    const bool hasReference {!m_reference.is_empty() && m_reference.get_precision() >= precision};
+    const long double distanceRe {hasReference ? static_cast<long double>(static_cast<SpanType>(m_centerRe - m_reference.get_re()) / m_spanRe) : 0};
+    const long double distanceIm {hasReference ? static_cast<long double>(static_cast<SpanType>(m_centerIm - m_reference.get_im()) / m_spanIm) : 0};
+
+    const auto& orbit {m_reference.get_orbit()};
+    const bool coversIterations {hasReference && (m_reference.get_max_iterations() >= m_maxIterations ||
+                                                  static_cast<int>(orbit.size()) - 1 < m_reference.get_max_iterations())};
+
+    if (!hasReference || !coversIterations || std::abs(distanceRe) > 1 || std::abs(distanceIm) > 1) {
+        CoordType re {m_centerRe}, im {m_centerIm};
+        re.set_precision(precision);
+        im.set_precision(precision);
+        m_reference.compute(re, im, m_maxIterations, cancel);
+        if (cancel.is_cancelled()) {
+            return;
+        }
+    }
+
+    // Offset of the top left pixel from the reference point
+    const double spanRe {static_cast<double>(m_spanRe)};
+    const double spanIm {static_cast<double>(m_spanIm)};
+    const double minRe {static_cast<double>(m_centerRe - m_reference.get_re()) - spanRe / 2};
+    const double minIm {static_cast<double>(m_centerIm - m_reference.get_im()) - spanIm / 2};
+
+    // Past the range of double the same offsets are kept with a separate exponent
+    const DeltaType deltaSpanRe {m_spanRe};
+    const DeltaType deltaSpanIm {m_spanIm};
+    const DeltaType deltaMinRe {DeltaType {static_cast<SpanType>(m_centerRe - m_reference.get_re())} - deltaSpanRe / 2};
+    const DeltaType deltaMinIm {DeltaType {static_cast<SpanType>(m_centerIm - m_reference.get_im())} - deltaSpanIm / 2};
+    const bool deep {std::min(deltaSpanRe / screen.x, deltaSpanIm / frameHeight).exponent < ReferenceOrbit::DeltaExponentLimit};
+
+    // Largest offset any pixel has from the reference
+    const double radius {std::hypot(std::max(std::abs(minRe), std::abs(minRe + spanRe)),
+                                    std::max(std::abs(minIm), std::abs(minIm + spanIm)))};
+
+    // Fit the series to that offset, deep views leave the skipping to the bilinear approximation
+    if (m_seriesApproximation && !deep) {
+        m_series.compute(m_reference, radius, std::min(spanRe / screen.x, spanIm / frameHeight), m_maxIterations);
+    } else {
+        m_series.reset();
+    }
+    const int skip {m_series.get_skip()};
+
+    // Bilinear approximation tables only need a rebuild for a new reference or a wider view
+    if (m_bilinearApproximation && !m_bla.is_built_for(m_reference, radius)) {
+        m_bla.build(m_reference, radius);
+    }
+    const BlaTable* bla {m_bilinearApproximation ? &m_bla : nullptr};
+
+    const bool smooth {!m_fractions.empty()};
+
+    // Pixels that fail the glitch criterion are left for the correction after the last pass
+    std::vector<unsigned char> glitched(static_cast<size_t>(screen.x) * screen.y);
+
+    // Iterate over the pixels of every tile, the scheduler balances the tiles over its threads
+    run_passes(screen, cancel, onPass, [&](const TileScheduler::Tile& tile, const Pass& pass) {
+        for (int y = tile.y; y < tile.y + tile.height; y += pass.step) {
+            for (int x = tile.x; x < tile.x + tile.width; x += pass.step) {
+                if (!pass.computes(x, y) || !is_missing(x, y, screen)) {
+                    continue;
+                }
+                bool glitch {false};
+                double norm {};
+                int iters {};
+
+                if (deep) {
+                    iters = m_reference.iterate(deltaMinRe + deltaSpanRe * DeltaType {static_cast<double>(x) / screen.x},
+                                                deltaMinIm + deltaSpanIm * DeltaType {static_cast<double>(top + y) / frameHeight},
+                                                m_maxIterations, bla, m_glitchCorrection ? &glitch : nullptr,
+                                                smooth ? &norm : nullptr);
+                } else {
+
+                    // Calculate the offset of the current pixel from the reference point
+                    double realOffset {minRe + spanRe * x / screen.x};
+                    double imagOffset {minIm + spanIm * (top + y) / frameHeight};
+
+                    // Start from the skipped iteration with the offset predicted by the series
+                    double dzRe {}, dzIm {};
+                    m_series.evaluate(realOffset, imagOffset, dzRe, dzIm);
+
+                    iters = m_reference.iterate(realOffset, imagOffset, m_maxIterations, skip, dzRe, dzIm, bla,
+                                                m_glitchCorrection ? &glitch : nullptr, smooth ? &norm : nullptr);
+                }
+
+                // Store the number of iterations of the current pixel, glitched pixels show the main
+                // reference's result in the previews until the correction replaces it
+                set_result(iters, x, y, screen, norm);
+                if (glitch) {
+                    glitched[static_cast<size_t>(y) * screen.x + x] = 1;
+                }
+            }
+        }
+    });
+
+    std::vector<int> pixels {};
+    for (size_t index = 0; index < glitched.size(); ++index) {
+        if (glitched[index]) {
+            pixels.push_back(static_cast<int>(index));
+        }
+    }
+
+    // The preview results of glitched pixels must not outlive a cancelled frame
+    const auto forget_glitches = [&] {
+        for (const int index : pixels) {
+            m_iterations[index] = Missing;
+        }
+    };
+    if (cancel.is_cancelled()) {
+        forget_glitches();
+        return;
+    }
+
+    m_glitchReferences = 0;
+    correct_glitches(screen, pixels, deltaMinRe, deltaMinIm, deltaSpanRe, deltaSpanIm, cancel);
+    if (cancel.is_cancelled()) {
+        forget_glitches();
+        return;
+    }
+
+    // Whatever is still glitched after the last reference keeps the main reference's result
+#pragma omp parallel for default(none) \
+    shared(screen, top, frameHeight, minRe, minIm, spanRe, spanIm, deltaMinRe, deltaMinIm, deltaSpanRe, deltaSpanIm, deep, skip, \
+           bla, smooth, pixels)
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        const int x {pixels[i] % screen.x};
+        const int y {pixels[i] / screen.x};
+        double norm {};
+        if (deep) {
+            const int iters {m_reference.iterate(deltaMinRe + deltaSpanRe * DeltaType {static_cast<double>(x) / screen.x},
+                                                 deltaMinIm + deltaSpanIm * DeltaType {static_cast<double>(top + y) / frameHeight},
+                                                 m_maxIterations, bla, nullptr, smooth ? &norm : nullptr)};
+            set_result(iters, x, y, screen, norm);
+            continue;
+        }
+        const double realOffset {minRe + spanRe * x / screen.x};
+        const double imagOffset {minIm + spanIm * (top + y) / frameHeight};
+
+        double dzRe {}, dzIm {};
+        m_series.evaluate(realOffset, imagOffset, dzRe, dzIm);
+        const int iters {m_reference.iterate(realOffset, imagOffset, m_maxIterations, skip, dzRe, dzIm, bla, nullptr,
+                                             smooth ? &norm : nullptr)};
+        set_result(iters, x, y, screen, norm);
+    }
+}
+
+/**
+ * Re-render glitched pixels against secondary references. Each round places a new reference on a glitched
+ * pixel inside the tile with the most glitches and iterates only the pixels still glitched against it;
+ * the ones that pass are done, the rest carry over to the next round.
+ *
+ * @param screen Size of the frame in pixels.
+ * @param pixels Indices of the glitched pixels, left holding the ones no reference could fix.
+ * @param minRe Real offset of the frame's top left pixel from the main reference.
+ * @param minIm Imaginary offset of the frame's top left pixel from the main reference.
+ * @param spanRe Width of the view.
+ * @param spanIm Height of the view.
+ * @param cancel Checked before every round.
+ */
+void Mandelbrot::correct_glitches(sf::Vector2i screen, std::vector<int>& pixels,
+                                  DeltaType minRe, DeltaType minIm, DeltaType spanRe, DeltaType spanIm,
+                                  const CancellationToken& cancel) {
+    const int frameHeight {frame_height(screen)};
+    const int tilesX {(screen.x + GlitchTileSize - 1) / GlitchTileSize};
+    const int tilesY {(screen.y + GlitchTileSize - 1) / GlitchTileSize};
+    const bool smooth {!m_fractions.empty()};
+
+    while (!pixels.empty() && m_glitchReferences < MaxGlitchReferences && !cancel.is_cancelled()) {
+
+        // Find the tile with the most glitched pixels and their centroid in it
+        std::vector<int> counts(static_cast<size_t>(tilesX) * tilesY);
+        for (const int index : pixels) {
+            ++counts[(index / screen.x / GlitchTileSize) * tilesX + index % screen.x / GlitchTileSize];
+        }
+        const int tile {static_cast<int>(std::max_element(counts.begin(), counts.end()) - counts.begin())};
+
+        long sumX {}, sumY {};
+        for (const int index : pixels) {
+            if ((index / screen.x / GlitchTileSize) * tilesX + index % screen.x / GlitchTileSize == tile) {
+                sumX += index % screen.x;
+                sumY += index / screen.x;
+            }
+        }
+        const long double centerX {static_cast<long double>(sumX) / counts[tile]};
+        const long double centerY {static_cast<long double>(sumY) / counts[tile]};
+
+        // The centroid of a ring of glitches can fall outside it, so use the glitched pixel nearest to it
+        int refX {}, refY {};
+        long double best {std::numeric_limits<long double>::max()};
+        for (const int index : pixels) {
+            const int x {index % screen.x};
+            const int y {index / screen.x};
+            const long double distance {(x - centerX) * (x - centerX) + (y - centerY) * (y - centerY)};
+            if (distance < best) {
+                best = distance;
+                refX = x;
+                refY = y;
+            }
+        }
+
+        ReferenceOrbit reference {};
+        const int precision {m_reference.get_precision()};
+        const DeltaType refRe {minRe + spanRe * DeltaType {static_cast<double>(refX) / screen.x}};
+        const DeltaType refIm {minIm + spanIm * DeltaType {static_cast<double>(m_bandTop + refY) / frameHeight}};
+        reference.compute(m_reference.get_re() + CoordType {refRe.mantissa, refRe.exponent, precision},
+                          m_reference.get_im() + CoordType {refIm.mantissa, refIm.exponent, precision},
+                          m_maxIterations, cancel);
+        if (cancel.is_cancelled()) {
+            return;
+        }
+        ++m_glitchReferences;
+
+        // Offsets are measured in whole pixels from the new reference
+        double radius {};
+        for (const int index : pixels) {
+            radius = std::max(radius, std::hypot(static_cast<double>(spanRe) * (index % screen.x - refX) / screen.x,
+                                                 static_cast<double>(spanIm) * (index / screen.x - refY) / frameHeight));
+        }
+        BlaTable bla {};
+        if (m_bilinearApproximation) {
+            bla.build(reference, radius);
+        }
+        const BlaTable* table {m_bilinearApproximation ? &bla : nullptr};
+
+        std::vector<unsigned char> glitched(pixels.size());
+
+#pragma omp parallel for default(none) \
+    shared(screen, frameHeight, spanRe, spanIm, pixels, reference, refX, refY, table, smooth, glitched)
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            const int x {pixels[i] % screen.x};
+            const int y {pixels[i] / screen.x};
+
+            bool glitch {false};
+            double norm {};
+            const int iters {reference.iterate(spanRe * DeltaType {static_cast<double>(x - refX) / screen.x},
+                                               spanIm * DeltaType {static_cast<double>(y - refY) / frameHeight},
+                                               m_maxIterations, table, &glitch, smooth ? &norm : nullptr)};
+            if (glitch) {
+                glitched[i] = 1;
+            } else {
+                set_result(iters, x, y, screen, norm);
+            }
+        }
+
+        std::vector<int> remaining {};
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            if (glitched[i]) {
+                remaining.push_back(pixels[i]);
+            }
+        }
+        pixels.swap(remaining);
+    }
+}
+
+/**
+ * Raise the precision of the view center so the pixels of the current view stay addressable.
+ */
+void Mandelbrot::update_precision() {
+    const int precision {BigFloat::precision_for(std::min(m_spanRe, m_spanIm) / m_width)};
+
+    if (precision > m_centerRe.get_precision()) {
+        m_centerRe.set_precision(precision);
+        m_centerIm.set_precision(precision);
     }
 }
 
-sf::Image Mandelbrot::get_image() {
-    return m_image;
+/**
+ * Convert an offset on the complex plane to the precision of the view center.
+ */
+Mandelbrot::CoordType Mandelbrot::to_coord(long double value) const {
+    return CoordType {value, m_centerRe.get_precision()};
+}
+
+Mandelbrot::CoordType Mandelbrot::to_coord(const SpanType& value) const {
+    return CoordType {value.mantissa, value.exponent, m_centerRe.get_precision()};
+}
+
+/**
+ * Center the view on a point given as a fraction of the current view and zoom into it.
+ *
+ * @param fractionX Horizontal position of the new center, 0 is the left edge and 1 the right edge.
+ * @param fractionY Vertical position of the new center, 0 is the top edge and 1 the bottom edge.
+ * @param zoomFactor How much smaller the new view is, values below 1 zoom out.
+ */
+void Mandelbrot::zoom_at(long double fractionX, long double fractionY, long double zoomFactor) {
+    reproject_image(fractionX, fractionY, zoomFactor);
+
+    // Zooming out by a whole factor keeps the old samples that land on the new grid
+    remap_iterations(fractionX - 0.5L / zoomFactor, fractionY - 0.5L / zoomFactor, 1.0L / zoomFactor);
+    move_center(fractionX - 0.5L, fractionY - 0.5L);
+
+    m_spanRe /= zoomFactor;
+    m_spanIm /= zoomFactor;
+    m_zoom *= zoomFactor;
+
+    update_precision();
+}
+
+/**
+ * Move the view by a fraction of its size.
+ *
+ * @param fractionX Horizontal offset, 1 moves by a full view width.
+ * @param fractionY Vertical offset, 1 moves by a full view height.
+ */
+void Mandelbrot::move(long double fractionX, long double fractionY) {
+    remap_iterations(fractionX, fractionY, 1.0L);
+    move_center(fractionX, fractionY);
+}
+
+void Mandelbrot::move_center(long double fractionX, long double fractionY) {
+    update_precision();
+
+    m_centerRe += to_coord(m_spanRe * SpanType {fractionX});
+    m_centerIm += to_coord(m_spanIm * SpanType {fractionY});
+}
+
+const Framebuffer& Mandelbrot::get_framebuffer() const {
+    return m_framebuffer;
+}
+
+const std::vector<int>& Mandelbrot::get_iterations() const {
+    return m_iterations;
+}
+
+const std::vector<float>& Mandelbrot::get_fractions() const {
+    return m_fractions;
 }
 
 long double Mandelbrot::get_min_re() const {
-    return m_minRe;
+    return static_cast<long double>(m_centerRe - to_coord(m_spanRe / 2));
 }
 
 void Mandelbrot::set_min_re(long double minRe) {
-    m_minRe = minRe;
+    invalidate_iterations();
+    const long double maxRe {get_max_re()};
+    m_spanRe = maxRe - minRe;
+    m_centerRe = to_coord(minRe) + to_coord(m_spanRe / 2);
 }
 
 // member initialization list
 Mandelbrot::Mandelbrot() : m_width {1920}, m_height {1080}, m_maxIterations{128},
-    m_minRe {-2.5}, m_maxRe {1.0}, m_minIm {-1.0}, m_maxIm {1.0}, m_zoom {1.0}
+    m_centerRe {-0.75L}, m_centerIm {0.0L}, m_spanRe {3.5}, m_spanIm {2.0}, m_zoom {1.0}
 {
-    init_variables();
 }
 
 void Mandelbrot::set_max_re(long double maxRe) {
-    m_maxRe = maxRe;
+    invalidate_iterations();
+    const long double minRe {get_min_re()};
+    m_spanRe = maxRe - minRe;
+    m_centerRe = to_coord(minRe) + to_coord(m_spanRe / 2);
 }
 
 void Mandelbrot::set_min_im(long double minIm) {
-    m_minIm = minIm;
+    invalidate_iterations();
+    const long double maxIm {get_max_im()};
+    m_spanIm = maxIm - minIm;
+    m_centerIm = to_coord(minIm) + to_coord(m_spanIm / 2);
 }
 
 void Mandelbrot::set_max_im(long double maxIm) {
-    m_maxIm = maxIm;
+    invalidate_iterations();
+    const long double minIm {get_min_im()};
+    m_spanIm = maxIm - minIm;
+    m_centerIm = to_coord(minIm) + to_coord(m_spanIm / 2);
+}
+
+/**
+ * Center the view on a point given at full precision, deep views are out of reach of the long double setters.
+ */
+void Mandelbrot::set_center(const BigFloat& centerRe, const BigFloat& centerIm) {
+    invalidate_iterations();
+    m_centerRe = centerRe;
+    m_centerIm = centerIm;
+
+    // Both coordinates carry the larger of the two precisions, and at least what the span needs
+    const int precision {std::max(centerRe.get_precision(), centerIm.get_precision())};
+    m_centerRe.set_precision(precision);
+    m_centerIm.set_precision(precision);
+    update_precision();
+}
+
+/**
+ * Render only a band of rows of the view from now on. The view is divided into rows as for a frame of the
+ * given height, the screen passed to mandy is the band's size and its first row is the given row of that
+ * frame. Every pixel gets the coordinate it has in the whole frame, so bands of any height add up to the
+ * pixels of a frame rendered at once. Only pixels fixed by extra glitch references can differ, those are
+ * placed inside the band.
+ *
+ * @param top First row of the band in the frame.
+ * @param frameHeight Rows of the whole frame, 0 renders the screen as the whole view again.
+ */
+void Mandelbrot::set_band(int top, int frameHeight) {
+    if (top != m_bandTop || frameHeight != m_frameHeight) {
+        invalidate_iterations();
+    }
+    m_bandTop = frameHeight > 0 ? top : 0;
+    m_frameHeight = frameHeight;
+}
+
+/**
+ * Set the width and height of the view on the complex plane around the current center.
+ * The zoom is measured against the default view, 3.5 wide.
+ */
+void Mandelbrot::set_span(long double spanRe, long double spanIm) {
+    invalidate_iterations();
+    m_spanRe = spanRe;
+    m_spanIm = spanIm;
+    m_zoom = 3.5L / spanRe;
+    update_precision();
 }
 
 long double Mandelbrot::get_max_re() const {
-    return m_maxRe;
+    return static_cast<long double>(m_centerRe + to_coord(m_spanRe / 2));
 }
 
 long double Mandelbrot::get_min_im() const {
-    return m_minIm;
+    return static_cast<long double>(m_centerIm - to_coord(m_spanIm / 2));
 }
 
 long double Mandelbrot::get_max_im() const {
-    return m_maxIm;
+    return static_cast<long double>(m_centerIm + to_coord(m_spanIm / 2));
 }
 
 void Mandelbrot::set_max_iterations(int maxIterations) {
@@ -156,27 +1199,164 @@ int Mandelbrot::get_max_iterations() const {
 }
 
 /**
- * Interpolates between two colors using linear interpolation.
- *
- * @param color1 the first color
- * @param color2 the second color
- * @param ratio the interpolation factor (a value between 0 and 1)
- * @return the interpolated color
+ * Total escape-time iterations the stored results stand for, bounded pixels count the full limit.
+ * Iterations skipped by the approximations count as well, so this measures the work a plain loop would do.
+ */
+std::uint64_t Mandelbrot::get_iteration_count() const {
+    std::uint64_t count {};
+
+#pragma omp parallel for default(none) reduction(+ : count)
+    for (size_t i = 0; i < m_iterations.size(); ++i) {
+        if (m_iterations[i] != Missing) {
+            count += static_cast<std::uint64_t>(std::min(m_iterations[i], m_iterationsLimit));
+        }
+    }
+    return count;
+}
+
+void Mandelbrot::set_exact_palette(bool exact) {
+    m_palette.set_exact(exact);
+}
+
+bool Mandelbrot::is_exact_palette() const {
+    return m_palette.is_exact();
+}
+
+void Mandelbrot::set_palette_offset(double offset) {
+    m_palette.set_offset(offset);
+}
+
+double Mandelbrot::get_palette_offset() const {
+    return m_palette.get_offset();
+}
+
+/**
+ * Color by the escape count plus a continuous fraction instead of whole counts, which removes the bands.
+ * The stored counts carry no fractions while it is off, so turning it on renders the next frame anew.
+ */
+void Mandelbrot::set_smooth_coloring(bool smoothColoring) {
+    if (smoothColoring == m_smoothColoring) {
+        return;
+    }
+    m_smoothColoring = smoothColoring;
+    if (smoothColoring) {
+        invalidate_iterations();
+    } else {
+        m_fractions.clear();
+    }
+}
+
+bool Mandelbrot::is_smooth_coloring() const {
+    return m_smoothColoring;
+}
+
+void Mandelbrot::set_interior_check(bool interiorCheck) {
+    m_interiorCheck = interiorCheck;
+    invalidate_iterations();
+}
+
+bool Mandelbrot::is_interior_check() const {
+    return m_interiorCheck;
+}
+
+void Mandelbrot::set_periodicity_check(bool periodicityCheck) {
+    m_periodicityCheck = periodicityCheck;
+    invalidate_iterations();
+}
+
+bool Mandelbrot::is_periodicity_check() const {
+    return m_periodicityCheck;
+}
+
+void Mandelbrot::set_perturbation(bool perturbation) {
+    m_perturbation = perturbation;
+    invalidate_iterations();
+}
+
+bool Mandelbrot::is_perturbation() const {
+    return m_perturbation;
+}
+
+void Mandelbrot::set_series_approximation(bool seriesApproximation) {
+    m_seriesApproximation = seriesApproximation;
+    invalidate_iterations();
+}
+
+bool Mandelbrot::is_series_approximation() const {
+    return m_seriesApproximation;
+}
+
+void Mandelbrot::set_bilinear_approximation(bool bilinearApproximation) {
+    m_bilinearApproximation = bilinearApproximation;
+    invalidate_iterations();
+}
+
+bool Mandelbrot::is_bilinear_approximation() const {
+    return m_bilinearApproximation;
+}
+
+void Mandelbrot::set_progressive(bool progressive) {
+    m_progressive = progressive;
+}
+
+bool Mandelbrot::is_progressive() const {
+    return m_progressive;
+}
+
+/**
+ * Keep finished tiles across frames, views on the lattice of a cached one take what it holds. Turning it
+ * off frees the cache, every frame renders from scratch then.
  */
-sf::Color Mandelbrot::linear_interp(const sf::Color& color1, const sf::Color& color2, double ratio) {
+void Mandelbrot::set_tile_cache(bool tileCache) {
+    m_tileCaching = tileCache;
+    if (!tileCache) {
+        m_tileCache.clear();
+        m_lattices.clear();
+    }
+}
+
+bool Mandelbrot::is_tile_cache() const {
+    return m_tileCaching;
+}
+
+/**
+ * Whether the image holds a reprojected stand-in for the next frame, until that frame starts rendering.
+ */
+bool Mandelbrot::has_preview() const {
+    return m_preview;
+}
 
-    // calculate the complement of the interpolation factor
-    double inverseRatio = 1.0 - ratio;
+void Mandelbrot::set_glitch_correction(bool glitchCorrection) {
+    m_glitchCorrection = glitchCorrection;
+    invalidate_iterations();
+}
 
-    // interpolate the RGB values of the colors using the given factor
-    auto red = static_cast<sf::Uint8>(inverseRatio * color1.r + ratio * color2.r);
-    auto green = static_cast<sf::Uint8>(inverseRatio * color1.g + ratio * color2.g);
-    auto blue = static_cast<sf::Uint8>(inverseRatio * color1.b + ratio * color2.b);
+bool Mandelbrot::is_glitch_correction() const {
+    return m_glitchCorrection;
+}
 
-    // return the interpolated color
-    return {red, green, blue};
+Mandelbrot::Precision Mandelbrot::get_precision() const {
+    return m_precision;
 }
 
+std::string Mandelbrot::get_precision_name() const {
+    const std::string isa {SimdKernel::isa_name(SimdKernel::get_isa())};
+
+    switch (m_precision) {
+        case Precision::Float:
+            return "float (" + isa + ")";
+        case Precision::Double:
+            return "double (" + isa + ")";
+        case Precision::LongDouble:
+            return "long double";
+        case Precision::DoubleDouble:
+            return "double-double";
+        default:
+            return "perturbation (" + std::to_string(m_reference.get_precision() * 32) + " bits, skip " +
+                   std::to_string(m_series.get_skip()) + (m_bilinearApproximation ? ", BLA" : "") +
+                   (m_glitchReferences ? ", " + std::to_string(m_glitchReferences) + " extra refs)" : ")");
+    }
+}
 
 long double Mandelbrot::get_zoom() const {
     return m_zoom;
@@ -0,0 +1,167 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::create(const std::string& path, std::size_t size) {
+    close();
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                         FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        return false;
+    }
+    return map(size, true);
+}
+
+bool MappedFile::open(const std::string& path, bool writable) {
+    close();
+    m_file = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ,
+                         nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size {};
+    if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size)) {
+        m_file = m_file == INVALID_HANDLE_VALUE ? nullptr : m_file;
+        close();
+        return false;
+    }
+    return map(static_cast<std::size_t>(size.QuadPart), writable);
+}
+
+/**
+ * Map the whole file, a new file is grown to the size by the mapping itself.
+ */
+bool MappedFile::map(std::size_t size, bool writable) {
+    if (size == 0) {
+        close();
+        return false;
+    }
+    const auto high {static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32)};
+    const auto low {static_cast<DWORD>(size & 0xFFFFFFFFu)};
+    m_mapping = CreateFileMappingA(m_file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, high, low, nullptr);
+    if (m_mapping == nullptr) {
+        close();
+        return false;
+    }
+    void* data {MapViewOfFile(m_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size)};
+    m_data = static_cast<std::uint8_t*>(data);
+    if (m_data == nullptr) {
+        close();
+        return false;
+    }
+    m_size = size;
+    m_writable = writable;
+    return true;
+}
+
+bool MappedFile::flush() {
+    if (m_data == nullptr || !m_writable) {
+        return m_data != nullptr;
+    }
+    return FlushViewOfFile(m_data, 0) && FlushFileBuffers(m_file);
+}
+
+void MappedFile::close() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr) {
+        CloseHandle(m_file);
+    }
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+
+bool MappedFile::create(const std::string& path, std::size_t size) {
+    close();
+    m_file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_file < 0 || ::ftruncate(m_file, static_cast<off_t>(size)) != 0) {
+        close();
+        return false;
+    }
+    return map(size, true);
+}
+
+bool MappedFile::open(const std::string& path, bool writable) {
+    close();
+    m_file = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+    struct stat status {};
+    if (m_file < 0 || ::fstat(m_file, &status) != 0) {
+        close();
+        return false;
+    }
+    return map(static_cast<std::size_t>(status.st_size), writable);
+}
+
+bool MappedFile::map(std::size_t size, bool writable) {
+    if (size == 0) {
+        close();
+        return false;
+    }
+    void* data {::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_file, 0)};
+    if (data == MAP_FAILED) {
+        close();
+        return false;
+    }
+    m_data = static_cast<std::uint8_t*>(data);
+    m_size = size;
+    m_writable = writable;
+    return true;
+}
+
+bool MappedFile::flush() {
+    if (m_data == nullptr || !m_writable) {
+        return m_data != nullptr;
+    }
+    return ::msync(m_data, m_size, MS_SYNC) == 0;
+}
+
+void MappedFile::close() {
+    if (m_data != nullptr) {
+        ::munmap(m_data, m_size);
+    }
+    if (m_file >= 0) {
+        ::close(m_file);
+    }
+    m_data = nullptr;
+    m_file = -1;
+    m_size = 0;
+}
+
+#endif
+
+std::uint8_t* MappedFile::data() {
+    return m_data;
+}
+
+const std::uint8_t* MappedFile::data() const {
+    return m_data;
+}
+
+std::size_t MappedFile::get_size() const {
+    return m_size;
+}
+
+bool MappedFile::is_open() const {
+    return m_data != nullptr;
+}
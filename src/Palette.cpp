@@ -0,0 +1,129 @@
+#include "Palette.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+Palette::Palette() : m_colors {
+        {0,0,0},
+        {255,0,0},
+        {255,127,0},
+        {255,255,0},
+        {0,255,0},
+        {0,0,255},
+        {75,0,130},
+        {148,0,211},
+        {255,0,255},
+        {255,255,255}
+}
+{
+}
+
+/**
+ * Rebuild the lookup table for the given iteration limit.
+ *
+ * In exact mode there is one slot per iteration, so slot i holds the gradient color at i / maxIterations,
+ * the same value the per-pixel interpolation used to produce. Otherwise the gradient is sampled into at
+ * most TableSize slots and neighbouring iteration counts share a slot.
+ *
+ * @param maxIterations The iteration limit the table will be indexed with.
+ */
+void Palette::build(int maxIterations) {
+    m_maxIterations = std::max(maxIterations, 1);
+
+    const int size {m_exact ? m_maxIterations : std::min(m_maxIterations, TableSize)};
+    m_table.resize(size);
+
+    // OpenMP parallelize the build, exact tables can hold millions of slots
+#pragma omp parallel for default(none) shared(size)
+    for (int i = 0; i < size; ++i) {
+        double mu {1.0 * i / size};
+        m_table[i] = interpolate_color(mu, m_colors);
+    }
+    update_shift();
+}
+
+bool Palette::is_built_for(int maxIterations) const {
+    return m_maxIterations != 0 && m_maxIterations == maxIterations;
+}
+
+void Palette::set_colors(const std::vector<sf::Color>& colors) {
+    assert(!colors.empty() && "Palette needs at least one color");
+    m_colors = colors;
+    m_maxIterations = 0;
+}
+
+void Palette::set_exact(bool exact) {
+    if (m_exact != exact) {
+        m_exact = exact;
+        m_maxIterations = 0;
+    }
+}
+
+/**
+ * Rotate the gradient along the iteration counts, which cycles the colors without a rebuild.
+ *
+ * @param offset Fraction of the gradient to rotate by, wrapped into [0, 1).
+ */
+void Palette::set_offset(double offset) {
+    m_offset = offset - std::floor(offset);
+    update_shift();
+}
+
+void Palette::update_shift() {
+    const auto size {static_cast<int>(m_table.size())};
+    m_shift = size > 0 ? static_cast<int>(m_offset * size) % size : 0;
+}
+
+const std::vector<sf::Color>& Palette::get_colors() const {
+    return m_colors;
+}
+
+bool Palette::is_exact() const {
+    return m_exact;
+}
+
+double Palette::get_offset() const {
+    return m_offset;
+}
+
+sf::Color Palette::interpolate_color(double colorIndex, const std::vector<sf::Color>& colors) {
+
+    // Determine the maximum color index based on the number of colors in the provided vector
+    const auto maxColor {colors.size() - 1};
+
+    // Determine the maximum color index based on the number of colors in the provided vector
+    colorIndex *= maxColor;
+
+    // Determine the lower index by casting down the color index to the nearest integer
+    auto lowerIndex {static_cast<size_t>(colorIndex)};
+
+    // Get the colors corresponding to the lower and upper color indices
+    auto color1 {colors[lowerIndex]};
+    auto color2 {colors[std::clamp(lowerIndex + 1, size_t{0}, colors.size() - 1)]};
+
+    // Interpolate the color between the two colors based on the color index and the lower index
+    return linear_interp(color1, color2, colorIndex - lowerIndex);
+}
+
+/**
+ * Interpolates between two colors using linear interpolation.
+ *
+ * @param color1 the first color
+ * @param color2 the second color
+ * @param ratio the interpolation factor (a value between 0 and 1)
+ * @return the interpolated color
+ */
+sf::Color Palette::linear_interp(const sf::Color& color1, const sf::Color& color2, double ratio) {
+
+    // calculate the complement of the interpolation factor
+    double inverseRatio = 1.0 - ratio;
+
+    // interpolate the RGB values of the colors using the given factor
+    auto red = static_cast<sf::Uint8>(inverseRatio * color1.r + ratio * color2.r);
+    auto green = static_cast<sf::Uint8>(inverseRatio * color1.g + ratio * color2.g);
+    auto blue = static_cast<sf::Uint8>(inverseRatio * color1.b + ratio * color2.b);
+
+    // return the interpolated color
+    return {red, green, blue};
+}
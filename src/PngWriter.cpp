@@ -0,0 +1,437 @@
+#include "PngWriter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+// CRC-32 of the PNG chunks, byte at a time from a table
+struct CrcTable {
+    std::uint32_t entries[256] {};
+
+    CrcTable() {
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            std::uint32_t c {n};
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) != 0 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[n] = c;
+        }
+    }
+};
+
+std::uint32_t update_crc(std::uint32_t crc, const std::uint8_t* data, std::size_t size) {
+    static const CrcTable table {};
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// Adler-32 of the uncompressed stream, the sums are reduced before they can overflow
+std::uint32_t update_adler(std::uint32_t adler, const std::uint8_t* data, std::size_t size) {
+    constexpr std::uint32_t Modulus {65521};
+    constexpr std::size_t MaxRun {5552};
+    std::uint32_t a {adler & 0xFFFF};
+    std::uint32_t b {adler >> 16};
+    while (size > 0) {
+        const std::size_t run {std::min(size, MaxRun)};
+        for (std::size_t i = 0; i < run; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= Modulus;
+        b %= Modulus;
+        data += run;
+        size -= run;
+    }
+    return b << 16 | a;
+}
+
+void put_big_endian(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    out.push_back(static_cast<std::uint8_t>(value >> 24));
+    out.push_back(static_cast<std::uint8_t>(value >> 16));
+    out.push_back(static_cast<std::uint8_t>(value >> 8));
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Deflate writes its fields starting at the least significant bit of every byte
+class BitWriter {
+private:
+    std::vector<std::uint8_t>& m_out;
+    std::uint64_t m_bits {};
+    int m_count {};
+
+public:
+    explicit BitWriter(std::vector<std::uint8_t>& out) : m_out {out} {}
+
+    void put(std::uint32_t value, int count) {
+        m_bits |= static_cast<std::uint64_t>(value) << m_count;
+        m_count += count;
+        while (m_count >= 8) {
+            m_out.push_back(static_cast<std::uint8_t>(m_bits));
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    void align() {
+        if (m_count > 0) {
+            put(0, 8 - m_count);
+        }
+    }
+};
+
+// The fixed Huffman codes of RFC 1951, bit reversed so they can be written like any other field
+struct DeflateTables {
+    struct Code {
+        std::uint16_t bits;
+        std::uint8_t length;
+    };
+
+    struct LengthCode {
+        std::uint16_t symbol;
+        std::uint8_t extraBits;
+        std::uint16_t extra;
+    };
+
+    Code literals[288] {};
+    Code distances[30] {};
+    LengthCode lengths[259] {};
+    std::uint8_t distanceSymbols[32769] {};
+
+    static constexpr int LengthBase[29] {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static constexpr int LengthExtra[29] {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                          3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static constexpr int DistanceBase[30] {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+                                           513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static constexpr int DistanceExtra[30] {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7,
+                                            8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    static std::uint16_t reverse(std::uint32_t code, int length) {
+        std::uint32_t reversed {};
+        for (int i = 0; i < length; ++i) {
+            reversed = reversed << 1 | ((code >> i) & 1);
+        }
+        return static_cast<std::uint16_t>(reversed);
+    }
+
+    DeflateTables() {
+        for (int symbol = 0; symbol < 288; ++symbol) {
+            if (symbol < 144) {
+                literals[symbol] = {reverse(0x30 + symbol, 8), 8};
+            } else if (symbol < 256) {
+                literals[symbol] = {reverse(0x190 + symbol - 144, 9), 9};
+            } else if (symbol < 280) {
+                literals[symbol] = {reverse(symbol - 256, 7), 7};
+            } else {
+                literals[symbol] = {reverse(0xC0 + symbol - 280, 8), 8};
+            }
+        }
+        for (int symbol = 0; symbol < 30; ++symbol) {
+            distances[symbol] = {reverse(symbol, 5), 5};
+        }
+
+        // Later codes overwrite earlier ones, so 258 ends up with its own code rather than 227 plus 31
+        for (int code = 0; code < 29; ++code) {
+            for (int length = LengthBase[code]; length < LengthBase[code] + (1 << LengthExtra[code]) && length <= 258;
+                 ++length) {
+                lengths[length] = {static_cast<std::uint16_t>(257 + code), static_cast<std::uint8_t>(LengthExtra[code]),
+                                   static_cast<std::uint16_t>(length - LengthBase[code])};
+            }
+        }
+        for (int code = 0; code < 30; ++code) {
+            for (int distance = DistanceBase[code]; distance < DistanceBase[code] + (1 << DistanceExtra[code]);
+                 ++distance) {
+                distanceSymbols[distance] = static_cast<std::uint8_t>(code);
+            }
+        }
+    }
+};
+
+/**
+ * Deflate one piece with LZ77 over hash chains and the fixed Huffman codes. Matches stay inside the piece,
+ * which is what lets the pieces be compressed in parallel. The piece ends with an empty stored block, so
+ * the output stops on a byte boundary and the next piece can follow it directly.
+ */
+void deflate_piece(const std::uint8_t* data, std::size_t size, std::vector<std::uint8_t>& out) {
+    static const DeflateTables tables {};
+    constexpr int HashBits {15};
+    constexpr int MinMatch {3};
+    constexpr std::size_t MaxMatch {258};
+    constexpr std::size_t Window {32768};
+    constexpr int MaxChain {16};
+
+    std::vector<std::int32_t> head(std::size_t {1} << HashBits, -1);
+    std::vector<std::int32_t> previous(size);
+    auto hash = [data](std::size_t position) {
+        const std::uint32_t bytes {static_cast<std::uint32_t>(data[position]) << 16 |
+                                   static_cast<std::uint32_t>(data[position + 1]) << 8 | data[position + 2]};
+        return (bytes * 2654435761u) >> (32 - HashBits);
+    };
+    auto insert = [&](std::size_t position) {
+        if (position + MinMatch <= size) {
+            const std::uint32_t key {hash(position)};
+            previous[position] = head[key];
+            head[key] = static_cast<std::int32_t>(position);
+        }
+    };
+
+    BitWriter bits {out};
+
+    // Not the final block, fixed Huffman codes
+    bits.put(0, 1);
+    bits.put(1, 2);
+
+    std::size_t position {};
+    while (position < size) {
+        std::size_t bestLength {};
+        std::size_t bestDistance {};
+        if (position + MinMatch <= size) {
+            const std::size_t maxLength {std::min(MaxMatch, size - position)};
+            std::int32_t candidate {head[hash(position)]};
+            for (int chain = 0; candidate >= 0 && position - candidate <= Window && chain < MaxChain; ++chain) {
+                const std::uint8_t* match {data + candidate};
+                if (match[bestLength] == data[position + bestLength]) {
+                    std::size_t length {};
+                    while (length < maxLength && match[length] == data[position + length]) {
+                        ++length;
+                    }
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = position - candidate;
+                        if (length == maxLength) {
+                            break;
+                        }
+                    }
+                }
+                candidate = previous[candidate];
+            }
+        }
+
+        if (bestLength >= MinMatch) {
+            const DeflateTables::LengthCode& length {tables.lengths[bestLength]};
+            const DeflateTables::Code& lengthCode {tables.literals[length.symbol]};
+            bits.put(lengthCode.bits, lengthCode.length);
+            bits.put(length.extra, length.extraBits);
+
+            const int symbol {tables.distanceSymbols[bestDistance]};
+            bits.put(tables.distances[symbol].bits, tables.distances[symbol].length);
+            bits.put(static_cast<std::uint32_t>(bestDistance - DeflateTables::DistanceBase[symbol]),
+                     DeflateTables::DistanceExtra[symbol]);
+
+            for (std::size_t i = 0; i < bestLength; ++i) {
+                insert(position + i);
+            }
+            position += bestLength;
+        } else {
+            const DeflateTables::Code& literal {tables.literals[data[position]]};
+            bits.put(literal.bits, literal.length);
+            insert(position);
+            ++position;
+        }
+    }
+
+    // End of block, then an empty stored block to reach a byte boundary
+    bits.put(tables.literals[256].bits, tables.literals[256].length);
+    bits.put(0, 1);
+    bits.put(0, 2);
+    bits.align();
+    const std::uint8_t emptyStored[4] {0x00, 0x00, 0xFF, 0xFF};
+    out.insert(out.end(), emptyStored, emptyStored + 4);
+}
+
+int paeth(int left, int up, int upLeft) {
+    const int estimate {left + up - upLeft};
+    const int distanceLeft {std::abs(estimate - left)};
+    const int distanceUp {std::abs(estimate - up)};
+    const int distanceUpLeft {std::abs(estimate - upLeft)};
+    if (distanceLeft <= distanceUp && distanceLeft <= distanceUpLeft) {
+        return left;
+    }
+    return distanceUp <= distanceUpLeft ? up : upLeft;
+}
+
+/**
+ * Filter one RGB row with each of the PNG filters and keep the one with the smallest sum of absolute
+ * differences, the usual heuristic for the filter that compresses best.
+ *
+ * @param out Receives the filter type followed by the filtered row.
+ */
+void filter_row(const std::uint8_t* row, const std::uint8_t* above, std::size_t bytes, std::uint8_t* out) {
+    constexpr std::size_t Pixel {3};
+    std::vector<std::uint8_t> candidates(4 * bytes);
+    long sums[4] {};
+
+    for (std::size_t i = 0; i < bytes; ++i) {
+        const int left {i >= Pixel ? row[i - Pixel] : 0};
+        const int up {above[i]};
+        const int upLeft {i >= Pixel ? above[i - Pixel] : 0};
+        const std::uint8_t filtered[4] {
+            static_cast<std::uint8_t>(row[i] - left),
+            static_cast<std::uint8_t>(row[i] - up),
+            static_cast<std::uint8_t>(row[i] - (left + up) / 2),
+            static_cast<std::uint8_t>(row[i] - paeth(left, up, upLeft)),
+        };
+        for (int filter = 0; filter < 4; ++filter) {
+            candidates[filter * bytes + i] = filtered[filter];
+            sums[filter] += std::abs(static_cast<std::int8_t>(filtered[filter]));
+        }
+    }
+
+    // Filter types are None, Sub, Up, Average and Paeth, None competes with the sum of the raw row
+    long best {};
+    for (std::size_t i = 0; i < bytes; ++i) {
+        best += std::abs(static_cast<std::int8_t>(row[i]));
+    }
+    int bestFilter {0};
+    for (int filter = 0; filter < 4; ++filter) {
+        if (sums[filter] < best) {
+            best = sums[filter];
+            bestFilter = filter + 1;
+        }
+    }
+
+    out[0] = static_cast<std::uint8_t>(bestFilter);
+    std::memcpy(out + 1, bestFilter == 0 ? row : &candidates[(bestFilter - 1) * bytes], bytes);
+}
+
+} // namespace
+
+bool PngWriter::open(const std::string& path, sf::Vector2i size) {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        return false;
+    }
+    m_size = size;
+    m_rowsWritten = 0;
+    m_adler = 1;
+    m_previousRow.assign(static_cast<std::size_t>(size.x) * 3, 0);
+
+    const std::uint8_t signature[8] {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    m_file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    // 8 bits per channel, RGB, deflate, adaptive filtering, no interlacing
+    std::vector<std::uint8_t> header {};
+    put_big_endian(header, static_cast<std::uint32_t>(size.x));
+    put_big_endian(header, static_cast<std::uint32_t>(size.y));
+    header.insert(header.end(), {8, 2, 0, 0, 0});
+    return write_chunk("IHDR", header.data(), header.size());
+}
+
+bool PngWriter::write_rows(const Framebuffer& band) {
+    const int rows {band.get_size().y};
+    const std::size_t rowBytes {static_cast<std::size_t>(m_size.x) * 3};
+    if (band.get_size().x != m_size.x || m_rowsWritten + rows > m_size.y) {
+        return false;
+    }
+
+    // Drop the alpha channel and filter every row against the one above it
+    std::vector<std::uint8_t> rgb(rowBytes * rows);
+    std::vector<std::uint8_t> filtered((rowBytes + 1) * rows);
+#pragma omp parallel for default(none) shared(band, rows, rowBytes, rgb)
+    for (int y = 0; y < rows; ++y) {
+        const sf::Uint8* source {band.row(y)};
+        std::uint8_t* destination {&rgb[y * rowBytes]};
+        for (std::size_t x = 0; x < rowBytes / 3; ++x) {
+            std::memcpy(destination + x * 3, source + x * 4, 3);
+        }
+    }
+#pragma omp parallel for default(none) shared(rows, rowBytes, rgb, filtered)
+    for (int y = 0; y < rows; ++y) {
+        const std::uint8_t* above {y == 0 ? m_previousRow.data() : &rgb[(y - 1) * rowBytes]};
+        filter_row(&rgb[y * rowBytes], above, rowBytes, &filtered[y * (rowBytes + 1)]);
+    }
+    std::copy(rgb.end() - static_cast<std::ptrdiff_t>(rowBytes), rgb.end(), m_previousRow.begin());
+
+    // The pieces are compressed independently, so all cores work on the band at once
+    const std::size_t pieceCount {(filtered.size() + PieceSize - 1) / PieceSize};
+    std::vector<std::vector<std::uint8_t>> pieces(pieceCount);
+#pragma omp parallel for default(none) shared(filtered, pieces, pieceCount) schedule(dynamic)
+    for (std::size_t i = 0; i < pieceCount; ++i) {
+        const std::size_t begin {i * PieceSize};
+        deflate_piece(&filtered[begin], std::min(PieceSize, filtered.size() - begin), pieces[i]);
+    }
+    m_adler = update_adler(m_adler, filtered.data(), filtered.size());
+
+    // The zlib header goes in front of the first piece: deflate with a 32 KiB window, no dictionary
+    if (m_rowsWritten == 0) {
+        const std::uint8_t zlibHeader[2] {0x78, 0x01};
+        pieces.front().insert(pieces.front().begin(), zlibHeader, zlibHeader + 2);
+    }
+    for (const auto& piece : pieces) {
+        if (!write_chunk("IDAT", piece.data(), piece.size())) {
+            return false;
+        }
+    }
+
+    m_rowsWritten += rows;
+    return true;
+}
+
+bool PngWriter::close() {
+    if (m_rowsWritten != m_size.y) {
+        m_file.close();
+        return false;
+    }
+
+    // A final block with nothing but its end code, padded to a byte, then the checksum
+    std::vector<std::uint8_t> trailer {0x03, 0x00};
+    put_big_endian(trailer, m_adler);
+    const bool written {write_chunk("IDAT", trailer.data(), trailer.size()) && write_chunk("IEND", nullptr, 0)};
+
+    m_file.close();
+    return written && !m_file.fail();
+}
+
+bool PngWriter::resume(const std::string& path, sf::Vector2i size, const State& state) {
+    std::error_code error {};
+    if (state.rows <= 0 || state.rows > size.y || state.previousRow.size() != static_cast<std::size_t>(size.x) * 3 ||
+        std::filesystem::file_size(path, error) < state.bytes || error) {
+        return false;
+    }
+    std::filesystem::resize_file(path, state.bytes, error);
+    if (error) {
+        return false;
+    }
+
+    m_file.open(path, std::ios::binary | std::ios::app);
+    if (!m_file) {
+        return false;
+    }
+    m_size = size;
+    m_rowsWritten = state.rows;
+    m_adler = state.adler;
+    m_previousRow = state.previousRow;
+    return true;
+}
+
+int PngWriter::get_rows_written() const {
+    return m_rowsWritten;
+}
+
+PngWriter::State PngWriter::get_state() {
+    m_file.flush();
+    return {static_cast<std::uint64_t>(m_file.tellp()), m_rowsWritten, m_adler, m_previousRow};
+}
+
+bool PngWriter::write_chunk(const char* type, const std::uint8_t* data, std::size_t size) {
+    std::vector<std::uint8_t> header {};
+    put_big_endian(header, static_cast<std::uint32_t>(size));
+    header.insert(header.end(), type, type + 4);
+
+    std::uint32_t crc {update_crc(0xFFFFFFFFu, header.data() + 4, 4)};
+    crc = update_crc(crc, data, size) ^ 0xFFFFFFFFu;
+    std::vector<std::uint8_t> footer {};
+    put_big_endian(footer, crc);
+
+    m_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    if (size > 0) {
+        m_file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+    m_file.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+    return static_cast<bool>(m_file);
+}
@@ -0,0 +1,229 @@
+#include "ReferenceOrbit.h"
+#include "BlaTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * Iterate the reference point in full precision until it escapes or reaches the iteration limit.
+ *
+ * @param re Real coordinate of the reference point, its precision is used for the whole orbit.
+ * @param im Imaginary coordinate of the reference point.
+ * @param maxIterations Iteration limit.
+ */
+void ReferenceOrbit::compute(const BigFloat& re, const BigFloat& im, int maxIterations, const CancellationToken& cancel) {
+    m_re = re;
+    m_im = im;
+    m_maxIterations = maxIterations;
+
+    static unsigned generation {};
+    m_generation = ++generation;
+
+    m_orbit.clear();
+    m_orbit.push_back({0.0, 0.0});
+
+    BigFloat realComponent {0, re.get_precision()}, imagComponent {0, re.get_precision()};
+
+    for (int iters = 0; iters < maxIterations; ++iters) {
+
+        // Deep orbits take long enough to be worth abandoning once the view moved on
+        if (iters % CancelInterval == 0 && cancel.is_cancelled()) {
+            m_orbit.clear();
+            return;
+        }
+
+        // Calculate the next point in the sequence
+        const BigFloat realSquare {realComponent * realComponent};
+        const BigFloat imagSquare {imagComponent * imagComponent};
+        const BigFloat cross {realComponent * imagComponent};
+        imagComponent = cross + cross + im;
+        realComponent = realSquare - imagSquare + re;
+
+        const Point point {static_cast<double>(realComponent), static_cast<double>(imagComponent)};
+        m_orbit.push_back(point);
+
+        // Stop at the first point outside the circle of radius 2, pixels that outlive the reference rebase
+        if (point.re * point.re + point.im * point.im > 2 * 2) {
+            break;
+        }
+    }
+}
+
+/**
+ * Perturbation loop: with z = Z + dz and c = C + dc, the offset follows dz' = (2 Z + dz) dz + dc.
+ * When the reference escapes before the pixel does, the pixel continues from the start of the orbit
+ * with its full value as the new offset, which is exact since Z_0 = 0.
+ * Wherever a bilinear approximation is valid, a whole run of iterations is applied at once.
+ * With detection enabled the loop stops at the first iteration that fails the glitch criterion, the pixel
+ * then has to be iterated again against a reference closer to it.
+ */
+int ReferenceOrbit::iterate(double dcRe, double dcIm, int maxIterations, int skip, double dzRe, double dzIm,
+                            const BlaTable* bla, bool* glitched, double* escapeNorm) const {
+    return iterate_from(skip, skip, dcRe, dcIm, maxIterations, dzRe, dzIm, bla, glitched, escapeNorm);
+}
+
+/**
+ * Perturbation loop for offsets below the range of double. The offsets are carried as FloatExp, which is
+ * several times slower, so the pixel moves over to the double loop as soon as its offset is representable
+ * and dc is either representable as well or too small to change the offset any more.
+ */
+int ReferenceOrbit::iterate(FloatExp<double> dcRe, FloatExp<double> dcIm, int maxIterations,
+                            const BlaTable* bla, bool* glitched, double* escapeNorm) const {
+    using Delta = FloatExp<double>;
+
+    if (escapeNorm != nullptr) {
+        *escapeNorm = 0.0;
+    }
+
+    const Point* orbit {m_orbit.data()};
+    const int last {static_cast<int>(m_orbit.size()) - 1};
+    const int dcExponent {std::max(dcRe.exponent, dcIm.exponent)};
+
+    Delta dzRe {}, dzIm {};
+    int m {};
+    int iters {};
+
+    while (iters < maxIterations) {
+        const int dzExponent {std::max(dzRe.exponent, dzIm.exponent)};
+        const bool dzFits {dzExponent > DeltaExponentLimit || dzExponent == Delta::ZeroExponent};
+        const bool dcFits {dcExponent > DeltaExponentLimit || dcExponent == Delta::ZeroExponent ||
+                           dzExponent - dcExponent > std::numeric_limits<double>::digits};
+        if (dzFits && dcFits) {
+            return iterate_from(m, iters, static_cast<double>(dcRe), static_cast<double>(dcIm), maxIterations,
+                                static_cast<double>(dzRe), static_cast<double>(dzIm), bla, glitched, escapeNorm);
+        }
+
+        // Rebase onto the start of the orbit once the reference runs out
+        if (m == last) {
+            dzRe += Delta {orbit[m].re};
+            dzIm += Delta {orbit[m].im};
+            m = 0;
+            continue;
+        }
+
+        // An offset this small is far inside every approximation radius that is not zero
+        const double dzNorm {static_cast<double>(dzRe * dzRe + dzIm * dzIm)};
+        const BlaTable::Step* step {bla ? bla->lookup(m, dzNorm, std::min(last - m, maxIterations - iters)) : nullptr};
+        if (step) {
+            const Delta aRe {step->a.re}, aIm {step->a.im}, bRe {step->b.re}, bIm {step->b.im};
+            const Delta nextRe {aRe * dzRe - aIm * dzIm + bRe * dcRe - bIm * dcIm};
+            dzIm = aRe * dzIm + aIm * dzRe + bRe * dcIm + bIm * dcRe;
+            dzRe = nextRe;
+            m += step->length;
+            iters += step->length;
+        } else {
+            const Delta twiceRe {Delta {2 * orbit[m].re} + dzRe};
+            const Delta twiceIm {Delta {2 * orbit[m].im} + dzIm};
+            const Delta nextRe {twiceRe * dzRe - twiceIm * dzIm + dcRe};
+            dzIm = twiceRe * dzIm + twiceIm * dzRe + dcIm;
+            dzRe = nextRe;
+            ++m;
+            ++iters;
+        }
+
+        // Same escape and glitch tests as the double loop, the offset only matters where it is representable
+        const double realComponent {orbit[m].re + static_cast<double>(dzRe)};
+        const double imagComponent {orbit[m].im + static_cast<double>(dzIm)};
+        const double norm {realComponent * realComponent + imagComponent * imagComponent};
+        if (norm > 2 * 2) {
+            if (escapeNorm != nullptr) {
+                *escapeNorm = norm;
+            }
+            return iters - 1;
+        }
+        if (glitched && norm < GlitchTolerance * (orbit[m].re * orbit[m].re + orbit[m].im * orbit[m].im)) {
+            *glitched = true;
+            return iters;
+        }
+    }
+    return maxIterations;
+}
+
+int ReferenceOrbit::iterate_from(int m, int iters, double dcRe, double dcIm, int maxIterations,
+                                 double dzRe, double dzIm, const BlaTable* bla, bool* glitched,
+                                 double* escapeNorm) const {
+    if (escapeNorm != nullptr) {
+        *escapeNorm = 0.0;
+    }
+
+    const Point* orbit {m_orbit.data()};
+    const int last {static_cast<int>(m_orbit.size()) - 1};
+
+    while (iters < maxIterations) {
+
+        // Rebase onto the start of the orbit once the reference runs out
+        if (m == last) {
+            dzRe += orbit[m].re;
+            dzIm += orbit[m].im;
+            m = 0;
+        }
+
+        // Skip the longest run of iterations that is still linear in the offset
+        const BlaTable::Step* step {bla ? bla->lookup(m, dzRe * dzRe + dzIm * dzIm, std::min(last - m, maxIterations - iters))
+                                        : nullptr};
+        if (step) {
+            const double nextRe {step->a.re * dzRe - step->a.im * dzIm + step->b.re * dcRe - step->b.im * dcIm};
+            dzIm = step->a.re * dzIm + step->a.im * dzRe + step->b.re * dcIm + step->b.im * dcRe;
+            dzRe = nextRe;
+            m += step->length;
+            iters += step->length;
+        } else {
+
+            // Advance the offset by one step of the reference orbit
+            const double twiceRe {2 * orbit[m].re + dzRe};
+            const double twiceIm {2 * orbit[m].im + dzIm};
+            const double nextRe {twiceRe * dzRe - twiceIm * dzIm + dcRe};
+            dzIm = twiceRe * dzIm + twiceIm * dzRe + dcIm;
+            dzRe = nextRe;
+            ++m;
+            ++iters;
+        }
+
+        // If the full value is outside the circle of radius 2, the pixel escaped on the previous iteration
+        const double realComponent {orbit[m].re + dzRe};
+        const double imagComponent {orbit[m].im + dzIm};
+        const double norm {realComponent * realComponent + imagComponent * imagComponent};
+        if (norm > 2 * 2) {
+            if (escapeNorm != nullptr) {
+                *escapeNorm = norm;
+            }
+            return iters - 1;
+        }
+
+        // The reference's own rounding error is now large against the full value
+        if (glitched && norm < GlitchTolerance * (orbit[m].re * orbit[m].re + orbit[m].im * orbit[m].im)) {
+            *glitched = true;
+            return iters;
+        }
+    }
+    return maxIterations;
+}
+
+bool ReferenceOrbit::is_empty() const {
+    return m_orbit.empty();
+}
+
+const BigFloat& ReferenceOrbit::get_re() const {
+    return m_re;
+}
+
+const BigFloat& ReferenceOrbit::get_im() const {
+    return m_im;
+}
+
+int ReferenceOrbit::get_max_iterations() const {
+    return m_maxIterations;
+}
+
+int ReferenceOrbit::get_precision() const {
+    return m_re.get_precision();
+}
+
+unsigned ReferenceOrbit::get_generation() const {
+    return m_generation;
+}
+
+const std::vector<ReferenceOrbit::Point>& ReferenceOrbit::get_orbit() const {
+    return m_orbit;
+}
@@ -0,0 +1,109 @@
+#include "Renderer.h"
+
+#include <utility>
+
+Renderer::Renderer(Mandelbrot& mandelbrot, sf::Vector2i screen)
+    : m_mandelbrot {mandelbrot}, m_screen {screen}
+{
+    m_thread = std::thread {&Renderer::render_loop, this};
+}
+
+Renderer::~Renderer() {
+    {
+        std::lock_guard<std::mutex> lock {m_commandMutex};
+        m_stop = true;
+        m_cancel.cancel();
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+/**
+ * Queue a change to the view, it is applied right before the next frame starts.
+ * The frame currently being rendered shows a stale view now, so it is cancelled.
+ *
+ * @param command Called on the render thread with the Mandelbrot object.
+ */
+void Renderer::post(Command command) {
+    {
+        std::lock_guard<std::mutex> lock {m_commandMutex};
+        m_commands.push_back(std::move(command));
+        m_cancel.cancel();
+    }
+    m_wake.notify_one();
+}
+
+bool Renderer::fetch_frame(Frame& frame, unsigned& generation, sf::Texture& texture) const {
+    std::lock_guard<std::mutex> lock {m_frameMutex};
+    if (m_frameGeneration == generation || m_framebuffer.empty()) {
+        return false;
+    }
+
+    const sf::Vector2i size {m_framebuffer.get_size()};
+    if (texture.getSize() != sf::Vector2u(size)) {
+        texture.create(size.x, size.y);
+    }
+    texture.update(m_framebuffer.data());
+
+    frame = m_frame;
+    generation = m_frameGeneration;
+    return true;
+}
+
+bool Renderer::is_busy() const {
+    return m_busy;
+}
+
+/**
+ * Sleep until the view changes, apply every queued command and render one frame with the result.
+ * Commands posted during a frame are batched into the next one, so a burst of input costs one frame.
+ */
+void Renderer::render_loop() {
+    while (true) {
+        std::vector<Command> commands {};
+        CancellationToken cancel {};
+        {
+            std::unique_lock<std::mutex> lock {m_commandMutex};
+            m_wake.wait(lock, [this] { return m_stop || m_dirty || !m_commands.empty(); });
+            if (m_stop) {
+                return;
+            }
+            commands.swap(m_commands);
+            m_dirty = false;
+            m_cancel = cancel;
+        }
+
+        m_busy = true;
+        for (auto& command : commands) {
+            command(m_mandelbrot);
+        }
+
+        // A zoom leaves the old frame stretched over the new view, showing it beats a frozen image
+        if (m_mandelbrot.has_preview()) {
+            publish_frame();
+        }
+
+        // Preview passes are shown as they finish, the window gets a coarse image after a fraction of the frame
+        m_mandelbrot.mandy(m_screen, cancel, [this] { publish_frame(); });
+
+        // A cancelled frame is partly stale, the commands that cancelled it are already queued
+        if (!cancel.is_cancelled()) {
+            publish_frame();
+        }
+        m_busy = false;
+    }
+}
+
+/**
+ * Hand the current pixels and view to the window. The copy happens outside the lock, so an upload in
+ * progress never waits for it.
+ */
+void Renderer::publish_frame() {
+    Frame frame {m_mandelbrot.get_max_iterations(), m_mandelbrot.get_zoom(), m_mandelbrot.get_precision_name()};
+    m_backBuffer.copy_from(m_mandelbrot.get_framebuffer());
+
+    std::lock_guard<std::mutex> lock {m_frameMutex};
+    m_frame = std::move(frame);
+    std::swap(m_framebuffer, m_backBuffer);
+    ++m_frameGeneration;
+}
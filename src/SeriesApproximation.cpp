@@ -0,0 +1,109 @@
+#include "SeriesApproximation.h"
+
+#include <algorithm>
+
+/**
+ * Advance the series coefficients along the reference orbit for as long as the series stays accurate.
+ *
+ * With dz' = 2 Z dz + dz^2 + dc the scaled coefficients follow
+ *     a_1' = 2 Z a_1 + r
+ *     a_k' = 2 Z a_k + sum_{j=1}^{k-1} a_j a_{k-j}
+ * One extra term is tracked as an estimate of the truncation error. The skip stops at the first iteration
+ * where that error is no longer small against the pixel to pixel change a_1 * spacing / r, or where some
+ * pixel of the view could have escaped.
+ *
+ * @param reference Reference orbit the offsets are measured from.
+ * @param radius Largest distance of a pixel from the reference point.
+ * @param spacing Distance between neighbouring pixels.
+ * @param maxIterations Iteration limit of the frame.
+ */
+void SeriesApproximation::compute(const ReferenceOrbit& reference, double radius, double spacing, int maxIterations) {
+    reset();
+    m_radius = radius;
+    if (!(radius > 0)) {
+        return;
+    }
+
+    const auto& orbit {reference.get_orbit()};
+    const int last {std::min(static_cast<int>(orbit.size()) - 1, maxIterations)};
+    const double threshold {Tolerance * spacing / radius};
+
+    // Index 0 is unused so that coefficient k sits at index k, the last entry is the error estimate
+    std::vector<Complex<double>> coefficients(m_order + 2), next(m_order + 2);
+
+    for (int n = 0; n < last; ++n) {
+        const Complex<double> twiceZ {2 * orbit[n].re, 2 * orbit[n].im};
+
+        next[1] = twiceZ * coefficients[1] + Complex<double> {radius, 0};
+        for (int k = 2; k <= m_order + 1; ++k) {
+            next[k] = twiceZ * coefficients[k];
+            for (int j = 1; j < k; ++j) {
+                next[k] += coefficients[j] * coefficients[k - j];
+            }
+        }
+
+        // The series is only usable while the omitted terms stay below the pixel resolution
+        const double linear {next[1].magnitude()};
+        if (!(next[m_order + 1].magnitude() <= threshold * linear)) {
+            break;
+        }
+
+        // No pixel may leave the escape radius before the iterations it skips
+        double offset {};
+        for (int k = 1; k <= m_order; ++k) {
+            offset += next[k].magnitude();
+        }
+        const double referenceMagnitude {std::sqrt(orbit[n + 1].re * orbit[n + 1].re + orbit[n + 1].im * orbit[n + 1].im)};
+        if (!(referenceMagnitude + offset <= 2)) {
+            break;
+        }
+
+        coefficients.swap(next);
+        m_skip = n + 1;
+    }
+
+    m_coefficients.assign(coefficients.begin() + 1, coefficients.begin() + 1 + m_order);
+}
+
+/**
+ * Evaluate the series at a pixel with Horner's scheme.
+ *
+ * @param dcRe Real part of the pixel's offset from the reference point.
+ * @param dcIm Imaginary part of the pixel's offset from the reference point.
+ * @param dzRe Receives the real part of the offset at the skip iteration.
+ * @param dzIm Receives the imaginary part of the offset at the skip iteration.
+ */
+void SeriesApproximation::evaluate(double dcRe, double dcIm, double& dzRe, double& dzIm) const {
+    if (m_skip == 0) {
+        dzRe = 0;
+        dzIm = 0;
+        return;
+    }
+
+    const Complex<double> u {dcRe / m_radius, dcIm / m_radius};
+
+    Complex<double> dz {};
+    for (size_t k = m_coefficients.size(); k-- > 0;) {
+        dz = (dz + m_coefficients[k]) * u;
+    }
+    dzRe = dz.re;
+    dzIm = dz.im;
+}
+
+void SeriesApproximation::reset() {
+    m_coefficients.clear();
+    m_radius = 0;
+    m_skip = 0;
+}
+
+void SeriesApproximation::set_order(int order) {
+    m_order = std::max(order, 1);
+}
+
+int SeriesApproximation::get_skip() const {
+    return m_skip;
+}
+
+int SeriesApproximation::get_order() const {
+    return m_order;
+}
@@ -0,0 +1,634 @@
+#include "SimdKernel.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+// This file must be compiled with -ffp-contract=off: a fused multiply-add rounds differently than the
+// separate multiply and add of the scalar loop, which would change iteration counts near the boundary.
+
+namespace {
+
+SimdKernel::Isa g_isa {SimdKernel::detect()};
+
+// Orbits of one group of lanes, laid out for aligned vector loads and stores
+template<typename T, int lanes>
+struct alignas(64) LaneOrbits {
+    T re[lanes];
+    T im[lanes];
+    T savedRe[lanes];
+    T savedIm[lanes];
+
+    // Pad the last group by repeating its final orbit, like the coordinates
+    void gather(const SimdKernel::Orbit<T>* orbits, int x, int count) {
+        for (int lane = 0; lane < lanes; ++lane) {
+            const SimdKernel::Orbit<T>& orbit {orbits[std::min(x + lane, count - 1)]};
+            re[lane] = orbit.re;
+            im[lane] = orbit.im;
+            savedRe[lane] = orbit.savedRe;
+            savedIm[lane] = orbit.savedIm;
+        }
+    }
+
+    // Keep the orbits of the lanes still running at the limit, lanes that stopped at the limit before
+    // it were proven bounded
+    void scatter(SimdKernel::Orbit<T>* orbits, int* iterations, int x, int count, int maxIterations,
+                 unsigned running) const {
+        for (int lane = 0; lane < lanes && x + lane < count; ++lane) {
+            if (running >> lane & 1u) {
+                orbits[x + lane] = {re[lane], im[lane], savedRe[lane], savedIm[lane]};
+            } else if (iterations[x + lane] == maxIterations) {
+                iterations[x + lane] = SimdKernel::Settled;
+            }
+        }
+    }
+};
+
+#ifdef SIMD_KERNEL_X86
+
+// Vector forms of SimdKernel::is_interior, a set lane lies inside the main cardioid or the period-2 bulb
+__attribute__((target("avx2")))
+__m256d interior_avx2(__m256d x, __m256d y) {
+    const __m256d y2 {_mm256_mul_pd(y, y)};
+    const __m256d shifted {_mm256_sub_pd(x, _mm256_set1_pd(0.25))};
+    const __m256d q {_mm256_add_pd(_mm256_mul_pd(shifted, shifted), y2)};
+    const __m256d cardioid {_mm256_cmp_pd(_mm256_mul_pd(q, _mm256_add_pd(q, shifted)),
+                                          _mm256_mul_pd(_mm256_set1_pd(0.25), y2), _CMP_NGT_UQ)};
+    const __m256d bulb {_mm256_add_pd(x, _mm256_set1_pd(1.0))};
+    return _mm256_or_pd(cardioid, _mm256_cmp_pd(_mm256_add_pd(_mm256_mul_pd(bulb, bulb), y2),
+                                                _mm256_set1_pd(0.0625), _CMP_NGT_UQ));
+}
+
+__attribute__((target("avx512f")))
+__mmask8 interior_avx512(__m512d x, __m512d y) {
+    const __m512d y2 {_mm512_mul_pd(y, y)};
+    const __m512d shifted {_mm512_sub_pd(x, _mm512_set1_pd(0.25))};
+    const __m512d q {_mm512_add_pd(_mm512_mul_pd(shifted, shifted), y2)};
+    const __m512d bulb {_mm512_add_pd(x, _mm512_set1_pd(1.0))};
+    return _mm512_cmp_pd_mask(_mm512_mul_pd(q, _mm512_add_pd(q, shifted)), _mm512_mul_pd(_mm512_set1_pd(0.25), y2), _CMP_NGT_UQ) |
+           _mm512_cmp_pd_mask(_mm512_add_pd(_mm512_mul_pd(bulb, bulb), y2), _mm512_set1_pd(0.0625), _CMP_NGT_UQ);
+}
+
+__attribute__((target("avx2")))
+__m256 interior_avx2(__m256 x, __m256 y) {
+    const __m256 y2 {_mm256_mul_ps(y, y)};
+    const __m256 shifted {_mm256_sub_ps(x, _mm256_set1_ps(0.25f))};
+    const __m256 q {_mm256_add_ps(_mm256_mul_ps(shifted, shifted), y2)};
+    const __m256 cardioid {_mm256_cmp_ps(_mm256_mul_ps(q, _mm256_add_ps(q, shifted)),
+                                         _mm256_mul_ps(_mm256_set1_ps(0.25f), y2), _CMP_NGT_UQ)};
+    const __m256 bulb {_mm256_add_ps(x, _mm256_set1_ps(1.0f))};
+    return _mm256_or_ps(cardioid, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(bulb, bulb), y2),
+                                                _mm256_set1_ps(0.0625f), _CMP_NGT_UQ));
+}
+
+__attribute__((target("avx512f")))
+__mmask16 interior_avx512(__m512 x, __m512 y) {
+    const __m512 y2 {_mm512_mul_ps(y, y)};
+    const __m512 shifted {_mm512_sub_ps(x, _mm512_set1_ps(0.25f))};
+    const __m512 q {_mm512_add_ps(_mm512_mul_ps(shifted, shifted), y2)};
+    const __m512 bulb {_mm512_add_ps(x, _mm512_set1_ps(1.0f))};
+    return _mm512_cmp_ps_mask(_mm512_mul_ps(q, _mm512_add_ps(q, shifted)), _mm512_mul_ps(_mm512_set1_ps(0.25f), y2), _CMP_NGT_UQ) |
+           _mm512_cmp_ps_mask(_mm512_add_ps(_mm512_mul_ps(bulb, bulb), y2), _mm512_set1_ps(0.0625f), _CMP_NGT_UQ);
+}
+
+/**
+ * Iterate four pixels per AVX2 register. Lanes that escaped keep iterating with their count frozen,
+ * the loop ends once every lane escaped or the iteration limit was reached.
+ */
+__attribute__((target("avx2")))
+void escape_time_avx2(const double* realCoords, const double* imagCoords, int count, int maxIterations, int* iterations,
+                      unsigned flags, SimdKernel::Orbit<double>* orbits, int startIteration,
+                      double* norms) {
+    constexpr int lanes {4};
+
+    const __m256d four {_mm256_set1_pd(4.0)};
+    const __m256d one {_mm256_set1_pd(1.0)};
+    const __m256d limit {_mm256_set1_pd(maxIterations)};
+    const __m256d tolerance {_mm256_set1_pd(SimdKernel::period_tolerance<double>())};
+    const __m256d absMask {_mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFF))};
+    const bool detectPeriod {(flags & SimdKernel::DetectPeriod) != 0};
+    const bool resume {orbits != nullptr && startIteration > 0};
+
+    for (int x = 0; x < count; x += lanes) {
+
+        // Pad the last group by repeating its final pixel
+        alignas(32) double re[lanes];
+        alignas(32) double im[lanes];
+        for (int lane = 0; lane < lanes; ++lane) {
+            re[lane] = realCoords[std::min(x + lane, count - 1)];
+            im[lane] = imagCoords[std::min(x + lane, count - 1)];
+        }
+        const __m256d cr {_mm256_load_pd(re)};
+        const __m256d ci {_mm256_load_pd(im)};
+
+        __m256d zr {_mm256_setzero_pd()}, zi {_mm256_setzero_pd()};
+        __m256d savedR {_mm256_setzero_pd()}, savedI {_mm256_setzero_pd()};
+        int checkpoint {SimdKernel::FirstCheckpoint};
+        __m256d iters {_mm256_setzero_pd()};
+        __m256d active {_mm256_castsi256_pd(_mm256_set1_epi64x(-1))};
+        LaneOrbits<double, lanes> state;
+
+        // Resumed lanes continue from their orbits, the run that stopped them already retired interior lanes
+        if (resume) {
+            state.gather(orbits, x, count);
+            zr = _mm256_load_pd(state.re);
+            zi = _mm256_load_pd(state.im);
+            savedR = _mm256_load_pd(state.savedRe);
+            savedI = _mm256_load_pd(state.savedIm);
+            checkpoint = SimdKernel::resume_checkpoint(startIteration, maxIterations);
+            iters = _mm256_set1_pd(startIteration);
+        } else if (flags & SimdKernel::SkipInterior) {
+
+            // Lanes inside the cardioid or the bulb start out retired with the full count
+            const __m256d interior {interior_avx2(cr, ci)};
+            active = _mm256_andnot_pd(interior, active);
+            iters = _mm256_and_pd(interior, limit);
+        }
+
+        __m256d zr2 {_mm256_mul_pd(zr, zr)}, zi2 {_mm256_mul_pd(zi, zi)};
+        __m256d escapeNorm {_mm256_setzero_pd()};
+
+        for (int i = resume ? startIteration : 0; i < maxIterations; ++i) {
+
+            // Same operation order as the scalar loop: zi = 2 * zr * zi + ci, zr = zr^2 - zi^2 + cr
+            zi = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(zr, zr), zi), ci);
+            zr = _mm256_add_pd(_mm256_sub_pd(zr2, zi2), cr);
+            zr2 = _mm256_mul_pd(zr, zr);
+            zi2 = _mm256_mul_pd(zi, zi);
+
+            // Retire lanes that left the circle of radius 2, the rest count one more iteration
+            const __m256d norm {_mm256_add_pd(zr2, zi2)};
+            const __m256d escaped {_mm256_cmp_pd(norm, four, _CMP_GT_OQ)};
+            if (norms != nullptr) {
+                escapeNorm = _mm256_blendv_pd(escapeNorm, norm, _mm256_and_pd(escaped, active));
+            }
+            active = _mm256_andnot_pd(escaped, active);
+            if (_mm256_movemask_pd(active) == 0) {
+                break;
+            }
+            iters = _mm256_add_pd(iters, _mm256_and_pd(active, one));
+
+            // Lanes whose orbit came back to the saved point are bounded, same test as SimdKernel::iterate
+            if (detectPeriod) {
+                const __m256d distance {_mm256_add_pd(_mm256_and_pd(_mm256_sub_pd(zr, savedR), absMask),
+                                                      _mm256_and_pd(_mm256_sub_pd(zi, savedI), absMask))};
+                const __m256d periodic {_mm256_and_pd(_mm256_cmp_pd(distance, tolerance, _CMP_LT_OQ), active)};
+                iters = _mm256_blendv_pd(iters, limit, periodic);
+                active = _mm256_andnot_pd(periodic, active);
+                if (_mm256_movemask_pd(active) == 0) {
+                    break;
+                }
+                if (i == checkpoint) {
+                    savedR = zr;
+                    savedI = zi;
+                    checkpoint = SimdKernel::next_checkpoint(checkpoint, maxIterations);
+                }
+            }
+        }
+
+        alignas(32) double result[lanes];
+        _mm256_store_pd(result, iters);
+        for (int lane = 0; lane < lanes && x + lane < count; ++lane) {
+            iterations[x + lane] = static_cast<int>(result[lane]);
+        }
+        if (norms != nullptr) {
+            _mm256_store_pd(result, escapeNorm);
+            std::copy(result, result + std::min(lanes, count - x), norms + x);
+        }
+
+        if (orbits != nullptr) {
+            _mm256_store_pd(state.re, zr);
+            _mm256_store_pd(state.im, zi);
+            _mm256_store_pd(state.savedRe, savedR);
+            _mm256_store_pd(state.savedIm, savedI);
+            state.scatter(orbits, iterations, x, count, maxIterations, static_cast<unsigned>(_mm256_movemask_pd(active)));
+        }
+    }
+}
+
+/**
+ * Iterate eight pixels per AVX-512 register, using mask registers to retire escaped lanes.
+ */
+__attribute__((target("avx512f")))
+void escape_time_avx512(const double* realCoords, const double* imagCoords, int count, int maxIterations, int* iterations,
+                        unsigned flags, SimdKernel::Orbit<double>* orbits, int startIteration,
+                        double* norms) {
+    constexpr int lanes {8};
+
+    const __m512d four {_mm512_set1_pd(4.0)};
+    const __m512d one {_mm512_set1_pd(1.0)};
+    const __m512d limit {_mm512_set1_pd(maxIterations)};
+    const __m512d tolerance {_mm512_set1_pd(SimdKernel::period_tolerance<double>())};
+    const bool detectPeriod {(flags & SimdKernel::DetectPeriod) != 0};
+    const bool resume {orbits != nullptr && startIteration > 0};
+
+    for (int x = 0; x < count; x += lanes) {
+
+        // Pad the last group by repeating its final pixel
+        alignas(64) double re[lanes];
+        alignas(64) double im[lanes];
+        for (int lane = 0; lane < lanes; ++lane) {
+            re[lane] = realCoords[std::min(x + lane, count - 1)];
+            im[lane] = imagCoords[std::min(x + lane, count - 1)];
+        }
+        const __m512d cr {_mm512_load_pd(re)};
+        const __m512d ci {_mm512_load_pd(im)};
+
+        __m512d zr {_mm512_setzero_pd()}, zi {_mm512_setzero_pd()};
+        __m512d savedR {_mm512_setzero_pd()}, savedI {_mm512_setzero_pd()};
+        int checkpoint {SimdKernel::FirstCheckpoint};
+        __m512d iters {_mm512_setzero_pd()};
+        __mmask8 active {0xFF};
+        LaneOrbits<double, lanes> state;
+
+        // Resumed lanes continue from their orbits, the run that stopped them already retired interior lanes
+        if (resume) {
+            state.gather(orbits, x, count);
+            zr = _mm512_load_pd(state.re);
+            zi = _mm512_load_pd(state.im);
+            savedR = _mm512_load_pd(state.savedRe);
+            savedI = _mm512_load_pd(state.savedIm);
+            checkpoint = SimdKernel::resume_checkpoint(startIteration, maxIterations);
+            iters = _mm512_set1_pd(startIteration);
+        } else if (flags & SimdKernel::SkipInterior) {
+            const __mmask8 interior {interior_avx512(cr, ci)};
+            active &= static_cast<__mmask8>(~interior);
+            iters = _mm512_mask_mov_pd(iters, interior, limit);
+        }
+
+        __m512d zr2 {_mm512_mul_pd(zr, zr)}, zi2 {_mm512_mul_pd(zi, zi)};
+        __m512d escapeNorm {_mm512_setzero_pd()};
+
+        for (int i = resume ? startIteration : 0; i < maxIterations; ++i) {
+
+            // Same operation order as the scalar loop: zi = 2 * zr * zi + ci, zr = zr^2 - zi^2 + cr
+            zi = _mm512_add_pd(_mm512_mul_pd(_mm512_add_pd(zr, zr), zi), ci);
+            zr = _mm512_add_pd(_mm512_sub_pd(zr2, zi2), cr);
+            zr2 = _mm512_mul_pd(zr, zr);
+            zi2 = _mm512_mul_pd(zi, zi);
+
+            // Retire lanes that left the circle of radius 2, the rest count one more iteration
+            const __m512d norm {_mm512_add_pd(zr2, zi2)};
+            const __mmask8 escaped {static_cast<__mmask8>(_mm512_cmp_pd_mask(norm, four, _CMP_GT_OQ) & active)};
+            if (norms != nullptr) {
+                escapeNorm = _mm512_mask_mov_pd(escapeNorm, escaped, norm);
+            }
+            active &= static_cast<__mmask8>(~escaped);
+            if (active == 0) {
+                break;
+            }
+            iters = _mm512_mask_add_pd(iters, active, iters, one);
+
+            if (detectPeriod) {
+                const __m512d distance {_mm512_add_pd(_mm512_abs_pd(_mm512_sub_pd(zr, savedR)),
+                                                      _mm512_abs_pd(_mm512_sub_pd(zi, savedI)))};
+                const __mmask8 periodic {static_cast<__mmask8>(_mm512_cmp_pd_mask(distance, tolerance, _CMP_LT_OQ) & active)};
+                iters = _mm512_mask_mov_pd(iters, periodic, limit);
+                active &= static_cast<__mmask8>(~periodic);
+                if (active == 0) {
+                    break;
+                }
+                if (i == checkpoint) {
+                    savedR = zr;
+                    savedI = zi;
+                    checkpoint = SimdKernel::next_checkpoint(checkpoint, maxIterations);
+                }
+            }
+        }
+
+        alignas(64) double result[lanes];
+        _mm512_store_pd(result, iters);
+        for (int lane = 0; lane < lanes && x + lane < count; ++lane) {
+            iterations[x + lane] = static_cast<int>(result[lane]);
+        }
+        if (norms != nullptr) {
+            _mm512_store_pd(result, escapeNorm);
+            std::copy(result, result + std::min(lanes, count - x), norms + x);
+        }
+
+        if (orbits != nullptr) {
+            _mm512_store_pd(state.re, zr);
+            _mm512_store_pd(state.im, zi);
+            _mm512_store_pd(state.savedRe, savedR);
+            _mm512_store_pd(state.savedIm, savedI);
+            state.scatter(orbits, iterations, x, count, maxIterations, static_cast<unsigned>(active));
+        }
+    }
+}
+
+/**
+ * Single precision AVX2 kernel, eight pixels per register. Counts are kept in integer lanes
+ * since a float counter stops incrementing past 2^24 iterations.
+ */
+__attribute__((target("avx2")))
+void escape_time_avx2(const float* realCoords, const float* imagCoords, int count, int maxIterations, int* iterations,
+                      unsigned flags, SimdKernel::Orbit<float>* orbits, int startIteration,
+                      float* norms) {
+    constexpr int lanes {8};
+
+    const __m256 four {_mm256_set1_ps(4.0f)};
+    const __m256i limit {_mm256_set1_epi32(maxIterations)};
+    const __m256 tolerance {_mm256_set1_ps(SimdKernel::period_tolerance<float>())};
+    const __m256 absMask {_mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF))};
+    const bool detectPeriod {(flags & SimdKernel::DetectPeriod) != 0};
+    const bool resume {orbits != nullptr && startIteration > 0};
+
+    for (int x = 0; x < count; x += lanes) {
+
+        // Pad the last group by repeating its final pixel
+        alignas(32) float re[lanes];
+        alignas(32) float im[lanes];
+        for (int lane = 0; lane < lanes; ++lane) {
+            re[lane] = realCoords[std::min(x + lane, count - 1)];
+            im[lane] = imagCoords[std::min(x + lane, count - 1)];
+        }
+        const __m256 cr {_mm256_load_ps(re)};
+        const __m256 ci {_mm256_load_ps(im)};
+
+        __m256 zr {_mm256_setzero_ps()}, zi {_mm256_setzero_ps()};
+        __m256 savedR {_mm256_setzero_ps()}, savedI {_mm256_setzero_ps()};
+        int checkpoint {SimdKernel::FirstCheckpoint};
+        __m256i iters {_mm256_setzero_si256()};
+        __m256 active {_mm256_castsi256_ps(_mm256_set1_epi32(-1))};
+        LaneOrbits<float, lanes> state;
+
+        // Resumed lanes continue from their orbits, the run that stopped them already retired interior lanes
+        if (resume) {
+            state.gather(orbits, x, count);
+            zr = _mm256_load_ps(state.re);
+            zi = _mm256_load_ps(state.im);
+            savedR = _mm256_load_ps(state.savedRe);
+            savedI = _mm256_load_ps(state.savedIm);
+            checkpoint = SimdKernel::resume_checkpoint(startIteration, maxIterations);
+            iters = _mm256_set1_epi32(startIteration);
+        } else if (flags & SimdKernel::SkipInterior) {
+            const __m256 interior {interior_avx2(cr, ci)};
+            active = _mm256_andnot_ps(interior, active);
+            iters = _mm256_and_si256(_mm256_castps_si256(interior), limit);
+        }
+
+        __m256 zr2 {_mm256_mul_ps(zr, zr)}, zi2 {_mm256_mul_ps(zi, zi)};
+        __m256 escapeNorm {_mm256_setzero_ps()};
+
+        for (int i = resume ? startIteration : 0; i < maxIterations; ++i) {
+
+            // Same operation order as the scalar loop: zi = 2 * zr * zi + ci, zr = zr^2 - zi^2 + cr
+            zi = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(zr, zr), zi), ci);
+            zr = _mm256_add_ps(_mm256_sub_ps(zr2, zi2), cr);
+            zr2 = _mm256_mul_ps(zr, zr);
+            zi2 = _mm256_mul_ps(zi, zi);
+
+            // Retire lanes that left the circle of radius 2, the active mask is -1 so subtracting it counts up
+            const __m256 norm {_mm256_add_ps(zr2, zi2)};
+            const __m256 escaped {_mm256_cmp_ps(norm, four, _CMP_GT_OQ)};
+            if (norms != nullptr) {
+                escapeNorm = _mm256_blendv_ps(escapeNorm, norm, _mm256_and_ps(escaped, active));
+            }
+            active = _mm256_andnot_ps(escaped, active);
+            if (_mm256_movemask_ps(active) == 0) {
+                break;
+            }
+            iters = _mm256_sub_epi32(iters, _mm256_castps_si256(active));
+
+            if (detectPeriod) {
+                const __m256 distance {_mm256_add_ps(_mm256_and_ps(_mm256_sub_ps(zr, savedR), absMask),
+                                                     _mm256_and_ps(_mm256_sub_ps(zi, savedI), absMask))};
+                const __m256 periodic {_mm256_and_ps(_mm256_cmp_ps(distance, tolerance, _CMP_LT_OQ), active)};
+                iters = _mm256_blendv_epi8(iters, limit, _mm256_castps_si256(periodic));
+                active = _mm256_andnot_ps(periodic, active);
+                if (_mm256_movemask_ps(active) == 0) {
+                    break;
+                }
+                if (i == checkpoint) {
+                    savedR = zr;
+                    savedI = zi;
+                    checkpoint = SimdKernel::next_checkpoint(checkpoint, maxIterations);
+                }
+            }
+        }
+
+        alignas(32) int result[lanes];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(result), iters);
+        for (int lane = 0; lane < lanes && x + lane < count; ++lane) {
+            iterations[x + lane] = result[lane];
+        }
+        if (norms != nullptr) {
+            alignas(32) float norm[lanes];
+            _mm256_store_ps(norm, escapeNorm);
+            std::copy(norm, norm + std::min(lanes, count - x), norms + x);
+        }
+
+        if (orbits != nullptr) {
+            _mm256_store_ps(state.re, zr);
+            _mm256_store_ps(state.im, zi);
+            _mm256_store_ps(state.savedRe, savedR);
+            _mm256_store_ps(state.savedIm, savedI);
+            state.scatter(orbits, iterations, x, count, maxIterations, static_cast<unsigned>(_mm256_movemask_ps(active)));
+        }
+    }
+}
+
+/**
+ * Single precision AVX-512 kernel, sixteen pixels per register.
+ */
+__attribute__((target("avx512f")))
+void escape_time_avx512(const float* realCoords, const float* imagCoords, int count, int maxIterations, int* iterations,
+                        unsigned flags, SimdKernel::Orbit<float>* orbits, int startIteration,
+                        float* norms) {
+    constexpr int lanes {16};
+
+    const __m512 four {_mm512_set1_ps(4.0f)};
+    const __m512i one {_mm512_set1_epi32(1)};
+    const __m512i limit {_mm512_set1_epi32(maxIterations)};
+    const __m512 tolerance {_mm512_set1_ps(SimdKernel::period_tolerance<float>())};
+    const bool detectPeriod {(flags & SimdKernel::DetectPeriod) != 0};
+    const bool resume {orbits != nullptr && startIteration > 0};
+
+    for (int x = 0; x < count; x += lanes) {
+
+        // Pad the last group by repeating its final pixel
+        alignas(64) float re[lanes];
+        alignas(64) float im[lanes];
+        for (int lane = 0; lane < lanes; ++lane) {
+            re[lane] = realCoords[std::min(x + lane, count - 1)];
+            im[lane] = imagCoords[std::min(x + lane, count - 1)];
+        }
+        const __m512 cr {_mm512_load_ps(re)};
+        const __m512 ci {_mm512_load_ps(im)};
+
+        __m512 zr {_mm512_setzero_ps()}, zi {_mm512_setzero_ps()};
+        __m512 savedR {_mm512_setzero_ps()}, savedI {_mm512_setzero_ps()};
+        int checkpoint {SimdKernel::FirstCheckpoint};
+        __m512i iters {_mm512_setzero_si512()};
+        __mmask16 active {0xFFFF};
+        LaneOrbits<float, lanes> state;
+
+        // Resumed lanes continue from their orbits, the run that stopped them already retired interior lanes
+        if (resume) {
+            state.gather(orbits, x, count);
+            zr = _mm512_load_ps(state.re);
+            zi = _mm512_load_ps(state.im);
+            savedR = _mm512_load_ps(state.savedRe);
+            savedI = _mm512_load_ps(state.savedIm);
+            checkpoint = SimdKernel::resume_checkpoint(startIteration, maxIterations);
+            iters = _mm512_set1_epi32(startIteration);
+        } else if (flags & SimdKernel::SkipInterior) {
+            const __mmask16 interior {interior_avx512(cr, ci)};
+            active &= static_cast<__mmask16>(~interior);
+            iters = _mm512_mask_mov_epi32(iters, interior, limit);
+        }
+
+        __m512 zr2 {_mm512_mul_ps(zr, zr)}, zi2 {_mm512_mul_ps(zi, zi)};
+        __m512 escapeNorm {_mm512_setzero_ps()};
+
+        for (int i = resume ? startIteration : 0; i < maxIterations; ++i) {
+
+            // Same operation order as the scalar loop: zi = 2 * zr * zi + ci, zr = zr^2 - zi^2 + cr
+            zi = _mm512_add_ps(_mm512_mul_ps(_mm512_add_ps(zr, zr), zi), ci);
+            zr = _mm512_add_ps(_mm512_sub_ps(zr2, zi2), cr);
+            zr2 = _mm512_mul_ps(zr, zr);
+            zi2 = _mm512_mul_ps(zi, zi);
+
+            // Retire lanes that left the circle of radius 2, the rest count one more iteration
+            const __m512 norm {_mm512_add_ps(zr2, zi2)};
+            const __mmask16 escaped {static_cast<__mmask16>(_mm512_cmp_ps_mask(norm, four, _CMP_GT_OQ) & active)};
+            if (norms != nullptr) {
+                escapeNorm = _mm512_mask_mov_ps(escapeNorm, escaped, norm);
+            }
+            active &= static_cast<__mmask16>(~escaped);
+            if (active == 0) {
+                break;
+            }
+            iters = _mm512_mask_add_epi32(iters, active, iters, one);
+
+            if (detectPeriod) {
+                const __m512 distance {_mm512_add_ps(_mm512_abs_ps(_mm512_sub_ps(zr, savedR)),
+                                                     _mm512_abs_ps(_mm512_sub_ps(zi, savedI)))};
+                const __mmask16 periodic {static_cast<__mmask16>(_mm512_cmp_ps_mask(distance, tolerance, _CMP_LT_OQ) & active)};
+                iters = _mm512_mask_mov_epi32(iters, periodic, limit);
+                active &= static_cast<__mmask16>(~periodic);
+                if (active == 0) {
+                    break;
+                }
+                if (i == checkpoint) {
+                    savedR = zr;
+                    savedI = zi;
+                    checkpoint = SimdKernel::next_checkpoint(checkpoint, maxIterations);
+                }
+            }
+        }
+
+        alignas(64) int result[lanes];
+        _mm512_store_si512(result, iters);
+        for (int lane = 0; lane < lanes && x + lane < count; ++lane) {
+            iterations[x + lane] = result[lane];
+        }
+        if (norms != nullptr) {
+            alignas(64) float norm[lanes];
+            _mm512_store_ps(norm, escapeNorm);
+            std::copy(norm, norm + std::min(lanes, count - x), norms + x);
+        }
+
+        if (orbits != nullptr) {
+            _mm512_store_ps(state.re, zr);
+            _mm512_store_ps(state.im, zi);
+            _mm512_store_ps(state.savedRe, savedR);
+            _mm512_store_ps(state.savedIm, savedI);
+            state.scatter(orbits, iterations, x, count, maxIterations, static_cast<unsigned>(active));
+        }
+    }
+}
+
+#endif
+
+} // namespace
+
+SimdKernel::Isa SimdKernel::detect() {
+#ifdef SIMD_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+SimdKernel::Isa SimdKernel::get_isa() {
+    return g_isa;
+}
+
+void SimdKernel::set_isa(Isa isa) {
+    g_isa = std::min(isa, detect());
+}
+
+const char* SimdKernel::isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Avx512:
+            return "AVX-512";
+        case Isa::Avx2:
+            return "AVX2";
+        default:
+            return "Scalar";
+    }
+}
+
+void SimdKernel::escape_time(const double* realCoords, const double* imagCoords, int count, int maxIterations, int* iterations,
+                             unsigned flags, Orbit<double>* orbits, int startIteration, double* norms) {
+    switch (g_isa) {
+#ifdef SIMD_KERNEL_X86
+        case Isa::Avx512:
+            escape_time_avx512(realCoords, imagCoords, count, maxIterations, iterations, flags, orbits, startIteration, norms);
+            break;
+        case Isa::Avx2:
+            escape_time_avx2(realCoords, imagCoords, count, maxIterations, iterations, flags, orbits, startIteration, norms);
+            break;
+#endif
+        default:
+            escape_time_scalar(realCoords, imagCoords, count, maxIterations, iterations, flags, orbits, startIteration, norms);
+            break;
+    }
+}
+
+void SimdKernel::escape_time(const float* realCoords, const float* imagCoords, int count, int maxIterations, int* iterations,
+                             unsigned flags, Orbit<float>* orbits, int startIteration, float* norms) {
+    switch (g_isa) {
+#ifdef SIMD_KERNEL_X86
+        case Isa::Avx512:
+            escape_time_avx512(realCoords, imagCoords, count, maxIterations, iterations, flags, orbits, startIteration, norms);
+            break;
+        case Isa::Avx2:
+            escape_time_avx2(realCoords, imagCoords, count, maxIterations, iterations, flags, orbits, startIteration, norms);
+            break;
+#endif
+        default:
+            escape_time_scalar(realCoords, imagCoords, count, maxIterations, iterations, flags, orbits, startIteration, norms);
+            break;
+    }
+}
+
+/**
+ * Reference implementation of the vector kernels, used when no vector instruction set is available.
+ */
+void SimdKernel::escape_time_scalar(const double* realCoords, const double* imagCoords, int count, int maxIterations, int* iterations,
+                                    unsigned flags, Orbit<double>* orbits, int startIteration, double* norms) {
+    for (int x = 0; x < count; ++x) {
+        iterations[x] = iterate(realCoords[x], imagCoords[x], maxIterations, flags,
+                                orbits != nullptr ? &orbits[x] : nullptr, startIteration,
+                                norms != nullptr ? &norms[x] : nullptr);
+    }
+}
+
+void SimdKernel::escape_time_scalar(const float* realCoords, const float* imagCoords, int count, int maxIterations, int* iterations,
+                                    unsigned flags, Orbit<float>* orbits, int startIteration, float* norms) {
+    for (int x = 0; x < count; ++x) {
+        iterations[x] = iterate(realCoords[x], imagCoords[x], maxIterations, flags,
+                                orbits != nullptr ? &orbits[x] : nullptr, startIteration,
+                                norms != nullptr ? &norms[x] : nullptr);
+    }
+}
@@ -0,0 +1,80 @@
+#include "TileCache.h"
+
+#include <functional>
+#include <iterator>
+
+std::size_t TileCache::KeyHash::operator()(const Key& key) const {
+    // Combine the fields the way boost::hash_combine does, neighbouring tiles spread over the buckets
+    std::size_t hash {std::hash<std::int64_t> {}(key.tx)};
+    const auto combine = [&hash](std::size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+    combine(std::hash<std::int64_t> {}(key.ty));
+    combine(std::hash<std::uint64_t> {}(key.lattice));
+    combine(std::hash<int> {}(key.maxIterations));
+    combine(std::hash<std::uint32_t> {}(key.formula));
+    return hash;
+}
+
+TileCache::TileCache(std::size_t capacity) : m_capacity {capacity} {}
+
+TileCache::Tile* TileCache::find(const Key& key) {
+    const auto found {m_index.find(key)};
+    if (found == m_index.end()) {
+        return nullptr;
+    }
+    m_tiles.splice(m_tiles.begin(), m_tiles, found->second);
+    return &found->second->second;
+}
+
+TileCache::Tile& TileCache::insert(const Key& key, bool smooth) {
+    if (Tile* tile {find(key)}) {
+        if (smooth && tile->fractions.empty()) {
+            tile->fractions.assign(static_cast<std::size_t>(Size) * Size, 0.0f);
+        }
+        return *tile;
+    }
+
+    // The tile used longest ago is reused for the new one, which saves the allocation
+    if (!m_tiles.empty() && m_tiles.size() >= m_capacity) {
+        m_index.erase(m_tiles.back().first);
+        m_tiles.splice(m_tiles.begin(), m_tiles, std::prev(m_tiles.end()));
+        m_tiles.front().first = key;
+    } else {
+        m_tiles.emplace_front(key, Tile {});
+    }
+    m_index[key] = m_tiles.begin();
+
+    Tile& tile {m_tiles.front().second};
+    tile.iterations.assign(static_cast<std::size_t>(Size) * Size, -1);
+    if (smooth) {
+        tile.fractions.assign(static_cast<std::size_t>(Size) * Size, 0.0f);
+    } else {
+        tile.fractions.clear();
+    }
+    return tile;
+}
+
+void TileCache::clear() {
+    m_index.clear();
+    m_tiles.clear();
+}
+
+/**
+ * Change how many tiles the cache holds, the tiles used longest ago are dropped if it holds more.
+ */
+void TileCache::set_capacity(std::size_t capacity) {
+    m_capacity = capacity;
+    while (m_tiles.size() > m_capacity) {
+        m_index.erase(m_tiles.back().first);
+        m_tiles.pop_back();
+    }
+}
+
+std::size_t TileCache::get_size() const {
+    return m_tiles.size();
+}
+
+std::size_t TileCache::get_capacity() const {
+    return m_capacity;
+}
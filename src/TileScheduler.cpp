@@ -0,0 +1,142 @@
+#include "TileScheduler.h"
+
+#include <algorithm>
+
+TileScheduler::TileScheduler(int threads) {
+    if (threads <= 0) {
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    for (int i = 0; i < threads; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    // The calling thread works as well, so the pool needs one thread less
+    for (int i = 1; i < threads; ++i) {
+        m_threads.emplace_back(&TileScheduler::worker_loop, this, i);
+    }
+}
+
+TileScheduler::~TileScheduler() {
+    {
+        std::lock_guard<std::mutex> lock {m_mutex};
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+/**
+ * Split the screen into tiles and run the work on every tile, returning once all of them are done.
+ * Neighbouring tiles start out in the same queue so a thread mostly works on one region of the screen.
+ *
+ * @param screen Size of the frame in pixels.
+ * @param tileSize Width and height of a tile, tiles at the right and bottom edges are cut to the screen.
+ * @param work Called once per tile, from any thread.
+ * @param cancel Checked before every tile, once it is cancelled the remaining tiles are dropped.
+ */
+void TileScheduler::run(sf::Vector2i screen, int tileSize, const Work& work, const CancellationToken& cancel) {
+    const int tilesX {(screen.x + tileSize - 1) / tileSize};
+    const int tilesY {(screen.y + tileSize - 1) / tileSize};
+    const int count {tilesX * tilesY};
+    const int queues {static_cast<int>(m_queues.size())};
+
+    for (int i = 0; i < count; ++i) {
+        const int x {i % tilesX * tileSize};
+        const int y {i / tilesX * tileSize};
+        const Tile tile {x, y, std::min(tileSize, screen.x - x), std::min(tileSize, screen.y - y)};
+
+        Queue& queue {*m_queues[static_cast<size_t>(i) * queues / count]};
+        std::lock_guard<std::mutex> lock {queue.mutex};
+        queue.tiles.push_back(tile);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock {m_mutex};
+        m_work = &work;
+        m_cancel = &cancel;
+        m_busy = static_cast<int>(m_threads.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(0);
+
+    // Stolen tiles may still be in flight on other threads
+    std::unique_lock<std::mutex> lock {m_mutex};
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_work = nullptr;
+    m_cancel = nullptr;
+}
+
+int TileScheduler::get_thread_count() const {
+    return static_cast<int>(m_queues.size());
+}
+
+void TileScheduler::worker_loop(int index) {
+    unsigned generation {};
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock {m_mutex};
+            m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+            if (m_stop) {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        drain(index);
+
+        {
+            std::lock_guard<std::mutex> lock {m_mutex};
+            --m_busy;
+        }
+        m_done.notify_one();
+    }
+}
+
+/**
+ * Work through the own queue, then steal until no queue has tiles left.
+ * No tiles are added during a frame, so a round of empty queues means the frame is handed out.
+ * Tiles of a cancelled frame are still taken off the queues, so the next frame starts with them empty.
+ */
+void TileScheduler::drain(int index) {
+    Tile tile {};
+    while (pop(index, tile) || steal(index, tile)) {
+        if (!m_cancel->is_cancelled()) {
+            (*m_work)(tile);
+        }
+    }
+}
+
+bool TileScheduler::pop(int index, Tile& tile) {
+    Queue& queue {*m_queues[index]};
+    std::lock_guard<std::mutex> lock {queue.mutex};
+    if (queue.tiles.empty()) {
+        return false;
+    }
+    tile = queue.tiles.back();
+    queue.tiles.pop_back();
+    return true;
+}
+
+/**
+ * Take the oldest tile of another queue, the owner works from the other end.
+ */
+bool TileScheduler::steal(int index, Tile& tile) {
+    const int queues {static_cast<int>(m_queues.size())};
+    for (int offset = 1; offset < queues; ++offset) {
+        Queue& queue {*m_queues[(index + offset) % queues]};
+        std::lock_guard<std::mutex> lock {queue.mutex};
+        if (!queue.tiles.empty()) {
+            tile = queue.tiles.front();
+            queue.tiles.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
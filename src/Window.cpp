@@ -22,7 +22,6 @@ Window::Window(int width, int height)
     init_window();
     load_font();
     set_text();
-    init_image();
     init_texture();
 }
 
@@ -36,34 +35,22 @@ bool Window::is_running() const {
     return m_window->isOpen();
 }
 
-void Window::handle_mouse_event(const sf::Event::MouseButtonEvent& mouseEvent, Mandelbrot& mandelbrot) const
-{
-    using PrecisionType = long double;
-
-    auto zoomAtMousePosition = [&](long double zoomFactor, double mouseX, double mouseY) {
-        PrecisionType minReal = mandelbrot.get_min_re();
-        PrecisionType maxReal = mandelbrot.get_max_re();
-        PrecisionType minImaginary = mandelbrot.get_min_im();
-        PrecisionType maxImaginary = mandelbrot.get_max_im();
-
-        PrecisionType centerX = minReal + (maxReal - minReal) * mouseX / m_screen.x;
-        PrecisionType centerY = minImaginary + (maxImaginary - minImaginary) * mouseY / m_screen.y;
+sf::Vector2i Window::get_screen() const {
+    return m_screen;
+}
 
-        PrecisionType newWidth = (maxReal - minReal) / zoomFactor;
-        PrecisionType newHeight = (maxImaginary - minImaginary) / zoomFactor;
-        mandelbrot.set_max_re(centerX + newWidth / m_scaleFactor);
-        mandelbrot.set_min_re(centerX - newWidth / m_scaleFactor);
-        mandelbrot.set_max_im(centerY + newHeight / m_scaleFactor);
-        mandelbrot.set_min_im(centerY - newHeight / m_scaleFactor);
-    };
+void Window::handle_mouse_event(const sf::Event::MouseButtonEvent& mouseEvent, Renderer& renderer) const
+{
+    // position of the click as a fraction of the screen, the view is re-centered there
+    const long double fractionX {static_cast<long double>(mouseEvent.x) / m_screen.x};
+    const long double fractionY {static_cast<long double>(mouseEvent.y) / m_screen.y};
+    const long double zoomFactor {m_zoomFactor};
 
     if (mouseEvent.button == sf::Mouse::Left) {
-        zoomAtMousePosition(m_zoomFactor, mouseEvent.x, mouseEvent.y);
-        mandelbrot.set_zoom(mandelbrot.get_zoom() * m_zoomFactor);
+        renderer.post([=](Mandelbrot& mandelbrot) { mandelbrot.zoom_at(fractionX, fractionY, zoomFactor); });
     }
     else if (mouseEvent.button == sf::Mouse::Right) {
-        zoomAtMousePosition(1.0 / m_zoomFactor, mouseEvent.x, mouseEvent.y);
-        mandelbrot.set_zoom(mandelbrot.get_zoom() / m_zoomFactor);
+        renderer.post([=](Mandelbrot& mandelbrot) { mandelbrot.zoom_at(fractionX, fractionY, 1.0 / zoomFactor); });
     }
 }
 
@@ -80,39 +67,40 @@ void Window::adjust_max_iterations(Mandelbrot& mandelbrot, int delta, double sca
     }
 }
 
-void Window::handle_key_press_event(const sf::Event& event, Mandelbrot& mandelbrot)
+void Window::handle_key_press_event(const sf::Event& event, Renderer& renderer)
 {
     if (event.type != sf::Event::KeyPressed) {
         return;
     }
 
-    using PrecisionType = long double;
-
-    const PrecisionType maxRe = mandelbrot.get_max_re();
-    const PrecisionType minRe = mandelbrot.get_min_re();
-    const PrecisionType maxIm = mandelbrot.get_max_im();
-    const PrecisionType minIm = mandelbrot.get_min_im();
-
-    const PrecisionType width = (maxRe - minRe) * 0.3;
-    const PrecisionType height = (maxIm - minIm) * 0.3;
+    // pan by 30% of the view
+    const long double step {0.3};
+    // cycle the colors by a 32nd of the gradient, only the coloring pass runs again
+    const double paletteStep {1.0 / 32};
 
     if (event.key.code == sf::Keyboard::Left) {
-        mandelbrot.set_min_re(minRe - width);
-        mandelbrot.set_max_re(maxRe - width);
+        renderer.post([=](Mandelbrot& mandelbrot) { mandelbrot.move(-step, 0); });
     } else if (event.key.code == sf::Keyboard::Right) {
-        mandelbrot.set_min_re(minRe + width);
-        mandelbrot.set_max_re(maxRe + width);
+        renderer.post([=](Mandelbrot& mandelbrot) { mandelbrot.move(step, 0); });
     } else if (event.key.code == sf::Keyboard::Up) {
-        mandelbrot.set_min_im(minIm - height);
-        mandelbrot.set_max_im(maxIm - height);
+        renderer.post([=](Mandelbrot& mandelbrot) { mandelbrot.move(0, -step); });
     } else if (event.key.code == sf::Keyboard::Down) {
-        mandelbrot.set_min_im(minIm + height);
-        mandelbrot.set_max_im(maxIm + height);
+        renderer.post([=](Mandelbrot& mandelbrot) { mandelbrot.move(0, step); });
+    } else if (event.key.code == sf::Keyboard::S) {
+        renderer.post([](Mandelbrot& mandelbrot) { mandelbrot.set_smooth_coloring(!mandelbrot.is_smooth_coloring()); });
+    } else if (event.key.code == sf::Keyboard::LBracket) {
+        renderer.post([=](Mandelbrot& mandelbrot) {
+            mandelbrot.set_palette_offset(mandelbrot.get_palette_offset() - paletteStep);
+        });
+    } else if (event.key.code == sf::Keyboard::RBracket) {
+        renderer.post([=](Mandelbrot& mandelbrot) {
+            mandelbrot.set_palette_offset(mandelbrot.get_palette_offset() + paletteStep);
+        });
     }
 }
 
 
-void Window::poll_events(Mandelbrot& mandelbrot) {
+void Window::poll_events(Renderer& renderer) {
     while (m_window->pollEvent(m_event))
         switch (m_event.type) {
             case sf::Event::Closed:
@@ -123,39 +111,39 @@ void Window::poll_events(Mandelbrot& mandelbrot) {
                     m_window->close();
 
                 if (m_event.type == sf::Event::KeyPressed) {
-                    handle_key_press_event(m_event, mandelbrot);
+                    handle_key_press_event(m_event, renderer);
                 }
                 break;
 
             case sf::Event::MouseWheelScrolled:
                 if (m_event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
-                    adjust_max_iterations(mandelbrot, m_event.mouseWheelScroll.delta, m_scaleFactor);
+                    const int delta {static_cast<int>(m_event.mouseWheelScroll.delta)};
+                    const double scaleFactor {static_cast<double>(m_scaleFactor)};
+                    renderer.post([=](Mandelbrot& mandelbrot) { adjust_max_iterations(mandelbrot, delta, scaleFactor); });
                 }
                 break;
 
         case sf::Event::MouseButtonPressed:
-            handle_mouse_event(m_event.mouseButton, mandelbrot);
+            handle_mouse_event(m_event.mouseButton, renderer);
             break;
         }
 }
 
-void Window::update(Mandelbrot& mandelbrot) {
-    poll_events(mandelbrot);
+void Window::update(Renderer& renderer) {
+    poll_events(renderer);
 }
 
-void Window::render(Mandelbrot &mandelbrot) {
+void Window::render(Renderer& renderer) {
     m_window->clear();
 
-    // calculate mandelbrot
-    mandelbrot.mandy(m_screen);
-
-    // update texture
-    update_texture(mandelbrot);
-    update_sprite();
+    // pick up the renderer's latest frame, the window keeps drawing the previous one until then
+    if (renderer.fetch_frame(m_frame, m_frameGeneration, m_texture)) {
+        update_sprite();
+    }
     m_window->draw(m_sprite);
 
     // update text
-    update_text(mandelbrot);
+    update_text(renderer);
 
     m_window->draw(m_text);
 
@@ -174,17 +162,17 @@ void Window::set_text() {
     m_text.setPosition(10, 10);
 }
 
-void Window::update_text(Mandelbrot& mandelbrot) {
+void Window::update_text(const Renderer& renderer) {
     std::ostringstream oss;
-    oss << "Iterations: " << mandelbrot.get_max_iterations() << "\n";
-    oss << "Zoom Factor: " << mandelbrot.get_zoom() << "\n";
+    oss << "Iterations: " << m_frame.maxIterations << "\n";
+    oss << "Zoom Factor: " << m_frame.zoom << "\n";
+    oss << "Precision: " << m_frame.precisionName << "\n";
+    if (renderer.is_busy()) {
+        oss << "Rendering...\n";
+    }
     m_text.setString(oss.str());
 }
 
-void Window::init_image() {
-    m_image.create(m_screen.x, m_screen.y);
-}
-
 void Window::init_texture() {
     if (!m_texture.create(m_screen.x, m_screen.y))
         assert("Failed to create texture");
@@ -193,7 +181,3 @@ void Window::init_texture() {
 void Window::update_sprite() {
     m_sprite.setTexture(m_texture);
 }
-
-void Window::update_texture(Mandelbrot& mandelbrot) {
-    m_texture.loadFromImage(mandelbrot.get_image());
-}
@@ -1,10 +1,21 @@
 #include <filesystem>
+#include <iostream>
+#include <string>
+#include "BatchRenderer.h"
 #include "Mandelbrot.h"
+#include "Renderer.h"
 #include "Window.h"
 
 static void modifyCurrentWorkingDirectory();
 
-int main () {
+static int renderHeadless(int argc, char** argv);
+
+int main (int argc, char** argv) {
+
+    // any option renders one view to a file, without a window
+    if (argc > 1) {
+        return renderHeadless(argc, argv);
+    }
 
     modifyCurrentWorkingDirectory();
 
@@ -14,10 +25,13 @@ int main () {
     // create window
     Window window{};
 
+    // render on a separate thread, the window only polls events and draws finished frames
+    Renderer renderer {mandelbrot, window.get_screen()};
+
     while (window.is_running()) {
-        window.update(mandelbrot);
+        window.update(renderer);
 
-        window.render(mandelbrot);
+        window.render(renderer);
     }
 
     return 0;
@@ -31,3 +45,21 @@ static void modifyCurrentWorkingDirectory()
     }
     auto cwd = std::filesystem::current_path();
 }
+
+static int renderHeadless(int argc, char** argv)
+{
+    const std::string first {argv[1]};
+    if (first == "--help" || first == "-h") {
+        BatchRenderer::print_usage(argv[0], std::cout);
+        return 0;
+    }
+
+    BatchRenderer::Options options {};
+    if (!BatchRenderer::parse_arguments(argc, argv, options, std::cerr)) {
+        BatchRenderer::print_usage(argv[0], std::cerr);
+        return 1;
+    }
+
+    BatchRenderer batchRenderer {options};
+    return batchRenderer.run(std::cout, std::cerr);
+}
@@ -0,0 +1,73 @@
+#include "BigFloat.h"
+#include "Mandelbrot.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct View {
+        const char* centerRe;
+        const char* centerIm;
+        long double span;
+        int maxIterations;
+    };
+
+    // Escape counts of the whole view, rendered band by band like a batch render does; 0 rows is one frame
+    std::vector<int> render(const View& view, sf::Vector2i size, int bandRows) {
+        BigFloat centerRe {}, centerIm {};
+        BigFloat::parse(view.centerRe, 4, centerRe);
+        BigFloat::parse(view.centerIm, 4, centerIm);
+
+        Mandelbrot mandelbrot {};
+        mandelbrot.set_tile_cache(false);
+
+        // Extra glitch references are placed inside the band, the pixels they fix may round differently
+        mandelbrot.set_glitch_correction(false);
+        mandelbrot.set_max_iterations(view.maxIterations);
+
+        const int rowsPerBand {bandRows > 0 ? bandRows : size.y};
+        std::vector<int> iterations {};
+        for (int top = 0; top < size.y; top += rowsPerBand) {
+            const int rows {std::min(rowsPerBand, size.y - top)};
+            mandelbrot.set_span(view.span, view.span / size.x * size.y);
+            mandelbrot.set_center(centerRe, centerIm);
+            mandelbrot.set_band(top, bandRows > 0 ? size.y : 0);
+            mandelbrot.mandy({size.x, rows});
+            iterations.insert(iterations.end(), mandelbrot.get_iterations().begin(), mandelbrot.get_iterations().end());
+        }
+        return iterations;
+    }
+}
+
+// Bands of any height have to add up to the same pixels as the view rendered as one frame
+int main() {
+    const View views[] {
+        {"-0.75", "0", 3.5L, 256},
+        {"-0.743643887037158", "0.131825904205312", 1e-9L, 2000},
+        {"-0.743643887037158704752191506114774", "0.131825904205311970493132056385139", 1e-20L, 12000},
+    };
+    const sf::Vector2i size {240, 160};
+
+    int failures {};
+    for (const View& view : views) {
+        const std::vector<int> frame {render(view, size, 0)};
+        for (const int bandRows : {7, 64}) {
+            const std::vector<int> bands {render(view, size, bandRows)};
+            long differences {};
+            for (size_t i = 0; i < frame.size(); ++i) {
+                differences += frame[i] != bands[i];
+            }
+            if (differences != 0) {
+                std::cerr << "span " << view.span << " in bands of " << bandRows << " rows: " << differences
+                          << " of " << frame.size() << " pixels differ from one frame\n";
+                ++failures;
+            }
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
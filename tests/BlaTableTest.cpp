@@ -0,0 +1,122 @@
+#include "BigFloat.h"
+#include "BlaTable.h"
+#include "Mandelbrot.h"
+#include "ReferenceOrbit.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+    struct View {
+        const char* centerRe;
+        const char* centerIm;
+        long double span;
+        int maxIterations;
+    };
+
+    // Escape counts of the view with plain perturbation, the series approximation is off so every
+    // iteration the bilinear approximation does not skip runs through the perturbation loop
+    std::vector<int> render(const View& view, sf::Vector2i size, bool bilinearApproximation) {
+        BigFloat centerRe {}, centerIm {};
+        BigFloat::parse(view.centerRe, 4, centerRe);
+        BigFloat::parse(view.centerIm, 4, centerIm);
+
+        Mandelbrot mandelbrot {};
+        mandelbrot.set_tile_cache(false);
+        mandelbrot.set_series_approximation(false);
+        mandelbrot.set_bilinear_approximation(bilinearApproximation);
+        mandelbrot.set_max_iterations(view.maxIterations);
+        mandelbrot.set_span(view.span, view.span / size.x * size.y);
+        mandelbrot.set_center(centerRe, centerIm);
+        mandelbrot.mandy(size);
+        return mandelbrot.get_iterations();
+    }
+
+    // Share of the iterations of pixels around the center that bilinear steps cover, walking the reference
+    // the way the perturbation loop does
+    double coverage(const View& view) {
+        BigFloat re {}, im {};
+        BigFloat::parse(view.centerRe, 4, re);
+        BigFloat::parse(view.centerIm, 4, im);
+
+        ReferenceOrbit reference {};
+        reference.compute(re, im, view.maxIterations);
+        const auto& orbit {reference.get_orbit()};
+        const int last {static_cast<int>(orbit.size()) - 1};
+
+        const double radius {static_cast<double>(view.span) / std::sqrt(2.0)};
+        BlaTable bla {};
+        bla.build(reference, radius);
+
+        long long iterations {};
+        long long skipped {};
+        constexpr int Pixels {64};
+        for (int i = 0; i < Pixels; ++i) {
+            const double angle {6.283185307179586 * i / Pixels};
+            const double dcRe {radius * (i + 1) / Pixels * std::cos(angle)};
+            const double dcIm {radius * (i + 1) / Pixels * std::sin(angle)};
+
+            // One pass over the reference, until the pixel escapes or the reference runs out
+            double dzRe {}, dzIm {};
+            int m {};
+            while (m < last) {
+                const BlaTable::Step* step {bla.lookup(m, dzRe * dzRe + dzIm * dzIm, last - m)};
+                if (step) {
+                    const double nextRe {step->a.re * dzRe - step->a.im * dzIm + step->b.re * dcRe -
+                                         step->b.im * dcIm};
+                    dzIm = step->a.re * dzIm + step->a.im * dzRe + step->b.re * dcIm + step->b.im * dcRe;
+                    dzRe = nextRe;
+                    m += step->length;
+                    skipped += step->length;
+                } else {
+                    const double twiceRe {2 * orbit[m].re + dzRe};
+                    const double twiceIm {2 * orbit[m].im + dzIm};
+                    const double nextRe {twiceRe * dzRe - twiceIm * dzIm + dcRe};
+                    dzIm = twiceRe * dzIm + twiceIm * dzRe + dcIm;
+                    dzRe = nextRe;
+                    ++m;
+                }
+                iterations += step ? step->length : 1;
+
+                const double realComponent {orbit[m].re + dzRe};
+                const double imagComponent {orbit[m].im + dzIm};
+                if (realComponent * realComponent + imagComponent * imagComponent > 2 * 2) {
+                    break;
+                }
+            }
+        }
+        return static_cast<double>(skipped) / static_cast<double>(iterations);
+    }
+}
+
+// Skipping runs with the bilinear approximation must give the same escape counts as iterating them
+int main() {
+    const View views[] {
+        {"-0.743643887037158704752191506114774", "0.131825904205311970493132056385139", 1e-14L, 5000},
+        {"-0.743643887037158704752191506114774", "0.131825904205311970493132056385139", 1e-30L, 10000},
+    };
+    const sf::Vector2i size {240, 135};
+
+    int failures {};
+    for (const View& view : views) {
+        std::cout << "span " << view.span << ": bilinear steps cover " << coverage(view) * 100
+                  << "% of the iterations\n";
+
+        const std::vector<int> plain {render(view, size, false)};
+        const std::vector<int> bilinear {render(view, size, true)};
+        long differences {};
+        for (size_t i = 0; i < plain.size(); ++i) {
+            differences += plain[i] != bilinear[i];
+        }
+        if (differences != 0) {
+            std::cerr << "span " << view.span << ": " << differences << " of " << plain.size()
+                      << " pixels differ with the bilinear approximation\n";
+            ++failures;
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}